@@ -0,0 +1,54 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if !defined(NDEBUG) || defined(COUNT_ALLOCATIONS)
+
+static std::atomic<Uint64> allocCount(0);
+
+bool AllocationCountingEnabled() {
+    return true;
+}
+
+Uint64 AllocationCount() {
+    return allocCount.load(std::memory_order_relaxed);
+}
+
+// The array and nothrow forms forward to these
+void* operator new(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Over-aligned types: the block from malloc is padded, and the pointer to free sits just
+// below the aligned address
+void* operator new(size_t size, std::align_val_t align) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = (size_t)align;
+    void* raw = std::malloc(size + alignment + sizeof(void*));
+    if (!raw) throw std::bad_alloc();
+    uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    ((void**)aligned)[-1] = raw;
+    return (void*)aligned;
+}
+void operator delete(void* p, std::align_val_t) noexcept {
+    if (p) std::free(((void**)p)[-1]);
+}
+void operator delete(void* p, size_t, std::align_val_t align) noexcept { operator delete(p, align); }
+
+#else
+
+bool AllocationCountingEnabled() {
+    return false;
+}
+
+Uint64 AllocationCount() {
+    return 0;
+}
+
+#endif
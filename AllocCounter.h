@@ -0,0 +1,10 @@
+#pragma once
+#include <SDL.h>
+
+// Allocation tracking for debug and benchmark builds. Unless NDEBUG is set (or whenever
+// COUNT_ALLOCATIONS is), AllocCounter.cpp replaces the global operator new and delete,
+// aligned forms included, with versions that count every allocation made through them,
+// from any thread. Compare two readings to see what a frame, a tick or a batch allocated.
+// Release builds keep the standard operators and always read 0.
+bool AllocationCountingEnabled();
+Uint64 AllocationCount();
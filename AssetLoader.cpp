@@ -0,0 +1,208 @@
+#include "AssetLoader.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+static double ElapsedMs(Uint64 start, Uint64 end) {
+    return (double)(end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// A pack entry only replaces the loose file if it is in the form this run can use directly
+static const PackEntry* UsablePackEntry(const AssetPack& pack, const std::string& path, AssetKind kind) {
+    const PackEntry* entry = FindPackEntry(pack, path.c_str());
+    if (!entry) return nullptr;
+    switch (kind) {
+        case ASSET_TEXTURE:
+            return entry->kind == PACK_RGBA && entry->size == (Uint64)entry->width * entry->height * 4 ? entry : nullptr;
+        case ASSET_CHUNK: {
+            int freq = 0, channels = 0;
+            Uint16 format = 0;
+            if (entry->kind != PACK_PCM || !Mix_QuerySpec(&freq, &format, &channels)) return nullptr;
+            if (entry->freq != (Uint32)freq || entry->format != format || entry->channels != channels) return nullptr;
+            return entry;
+        }
+        default:
+            return entry->kind == PACK_FILE ? entry : nullptr;
+    }
+}
+
+int QueueAsset(AssetLoader& loader, const std::string& path, AssetKind kind, bool critical, int fontSize) {
+    std::unique_ptr<Asset> asset(new Asset());
+    asset->path = path;
+    asset->kind = kind;
+    asset->critical = critical;
+    asset->fontSize = fontSize;
+    if (loader.pack) asset->packed = UsablePackEntry(*loader.pack, path, kind);
+    loader.assets.push_back(std::move(asset));
+    loader.pending++;
+    return (int)loader.assets.size() - 1;
+}
+
+static bool ReadFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    out.resize((size_t)file.tellg());
+    file.seekg(0);
+    return (bool)file.read(out.data(), out.size());
+}
+
+static bool OpenPacked(Asset& asset, const Uint8* data) {
+    switch (asset.kind) {
+        case ASSET_CHUNK:
+            asset.chunk = Mix_QuickLoad_RAW((Uint8*)data, (Uint32)asset.packed->size);
+            return asset.chunk != nullptr;
+        case ASSET_MUSIC:
+            asset.music = Mix_LoadMUS_RW(SDL_RWFromConstMem(data, (int)asset.packed->size), 1);
+            return asset.music != nullptr;
+        default:
+            return true; // textures and fonts are read in place on the main thread
+    }
+}
+
+static bool DecodeFile(Asset& asset) {
+    switch (asset.kind) {
+        case ASSET_TEXTURE:
+            asset.surface = IMG_Load(asset.path.c_str());
+            return asset.surface != nullptr;
+        case ASSET_FONT:
+            return ReadFile(asset.path, asset.fileData);
+        case ASSET_CHUNK:
+            asset.chunk = Mix_LoadWAV(asset.path.c_str());
+            return asset.chunk != nullptr;
+        case ASSET_MUSIC:
+            asset.music = Mix_LoadMUS(asset.path.c_str());
+            return asset.music != nullptr;
+    }
+    return false;
+}
+
+static void DecodeAsset(Asset& asset, const AssetPack* pack) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok = asset.packed ? OpenPacked(asset, PackEntryData(*pack, *asset.packed)) : DecodeFile(asset);
+    asset.decodeMs = ElapsedMs(start, SDL_GetPerformanceCounter());
+    asset.state.store(ok ? ASSET_DECODED : ASSET_FAILED, std::memory_order_release);
+}
+
+static void WorkerLoop(AssetLoader* loader) {
+    for (;;) {
+        size_t i = loader->next.fetch_add(1);
+        if (i >= loader->assets.size()) return;
+        DecodeAsset(*loader->assets[i], loader->pack);
+    }
+}
+
+void StartAssetLoader(AssetLoader& loader, int threadCount) {
+    loader.startCounter = SDL_GetPerformanceCounter();
+    threadCount = std::max(1, std::min(threadCount, (int)loader.assets.size()));
+    for (int i = 0; i < threadCount; i++) loader.workers.emplace_back(WorkerLoop, &loader);
+}
+
+static bool UploadAsset(Asset& asset, const AssetPack* pack, SDL_Renderer* renderer) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (asset.kind == ASSET_TEXTURE && asset.packed) {
+        int w = (int)asset.packed->width, h = (int)asset.packed->height;
+        asset.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, w, h);
+        if (!asset.texture) return false;
+        SDL_UpdateTexture(asset.texture, nullptr, PackEntryData(*pack, *asset.packed), w * 4);
+        SDL_SetTextureBlendMode(asset.texture, SDL_BLENDMODE_BLEND);
+    } else if (asset.kind == ASSET_TEXTURE) {
+        asset.texture = SDL_CreateTextureFromSurface(renderer, asset.surface);
+        SDL_FreeSurface(asset.surface);
+        asset.surface = nullptr;
+        if (!asset.texture) return false;
+    } else if (asset.kind == ASSET_FONT) {
+        SDL_RWops* rw = asset.packed ? SDL_RWFromConstMem(PackEntryData(*pack, *asset.packed), (int)asset.packed->size)
+                                     : SDL_RWFromConstMem(asset.fileData.data(), (int)asset.fileData.size());
+        asset.font = TTF_OpenFontRW(rw, 1, asset.fontSize);
+        if (!asset.font) return false;
+    }
+    asset.uploadMs = ElapsedMs(start, SDL_GetPerformanceCounter());
+    return true;
+}
+
+bool PumpAssets(AssetLoader& loader, SDL_Renderer* renderer) {
+    bool ok = true;
+    for (auto& asset : loader.assets) {
+        if (loader.pending == 0) break;
+        if (asset->done) continue;
+        int state = asset->state.load(std::memory_order_acquire);
+        if (state == ASSET_QUEUED) continue;
+        asset->done = true;
+        loader.pending--;
+        if (state == ASSET_DECODED && UploadAsset(*asset, loader.pack, renderer)) {
+            asset->state.store(ASSET_READY);
+            std::cout << "asset " << asset->path << (asset->packed ? " (pack)" : "") << ": decode " << asset->decodeMs << " ms, upload "
+                      << asset->uploadMs << " ms, ready at "
+                      << ElapsedMs(loader.startCounter, SDL_GetPerformanceCounter()) << " ms" << std::endl;
+        } else {
+            asset->state.store(ASSET_FAILED);
+            std::cerr << "Error loading asset: " << asset->path << std::endl;
+            if (asset->critical) ok = false;
+        }
+    }
+    return ok;
+}
+
+static bool CriticalPending(const AssetLoader& loader) {
+    for (const auto& asset : loader.assets) {
+        int state = asset->state.load(std::memory_order_acquire);
+        if (asset->critical && state != ASSET_READY && state != ASSET_FAILED) return true;
+    }
+    return false;
+}
+
+bool WaitForCriticalAssets(AssetLoader& loader, SDL_Renderer* renderer) {
+    while (CriticalPending(loader)) {
+        if (!PumpAssets(loader, renderer)) return false;
+        SDL_Delay(1);
+    }
+    if (!PumpAssets(loader, renderer)) return false;
+    std::cout << "critical assets ready after " << ElapsedMs(loader.startCounter, SDL_GetPerformanceCounter())
+              << " ms" << std::endl;
+    return true;
+}
+
+bool AssetsPending(const AssetLoader& loader) {
+    return loader.pending > 0;
+}
+
+void DestroyAssets(AssetLoader& loader) {
+    for (std::thread& worker : loader.workers) worker.join();
+    loader.workers.clear();
+    for (auto& asset : loader.assets) {
+        if (asset->surface) SDL_FreeSurface(asset->surface);
+        if (asset->texture) SDL_DestroyTexture(asset->texture);
+        if (asset->font) TTF_CloseFont(asset->font);
+        if (asset->chunk) Mix_FreeChunk(asset->chunk);
+        if (asset->music) Mix_FreeMusic(asset->music);
+    }
+    loader.assets.clear();
+    loader.pending = 0;
+}
+
+static const Asset* ReadyAsset(const AssetLoader& loader, int id) {
+    if (id < 0 || id >= (int)loader.assets.size()) return nullptr;
+    const Asset* asset = loader.assets[id].get();
+    return asset->state.load(std::memory_order_relaxed) == ASSET_READY ? asset : nullptr;
+}
+
+SDL_Texture* GetTexture(const AssetLoader& loader, int id) {
+    const Asset* asset = ReadyAsset(loader, id);
+    return asset ? asset->texture : nullptr;
+}
+
+TTF_Font* GetFont(const AssetLoader& loader, int id) {
+    const Asset* asset = ReadyAsset(loader, id);
+    return asset ? asset->font : nullptr;
+}
+
+Mix_Chunk* GetChunk(const AssetLoader& loader, int id) {
+    const Asset* asset = ReadyAsset(loader, id);
+    return asset ? asset->chunk : nullptr;
+}
+
+Mix_Music* GetMusic(const AssetLoader& loader, int id) {
+    const Asset* asset = ReadyAsset(loader, id);
+    return asset ? asset->music : nullptr;
+}
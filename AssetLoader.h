@@ -0,0 +1,65 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AssetPack.h"
+
+enum AssetKind { ASSET_TEXTURE, ASSET_FONT, ASSET_CHUNK, ASSET_MUSIC };
+enum AssetState { ASSET_QUEUED, ASSET_DECODED, ASSET_READY, ASSET_FAILED };
+
+// One file on its way from disk to something the game can use. Workers own it until
+// state becomes ASSET_DECODED; from then on only the main thread touches it.
+struct Asset {
+    std::string path;
+    AssetKind kind = ASSET_TEXTURE;
+    bool critical = false;          // the menu cannot be shown without it
+    int fontSize = 0;
+    std::atomic<int> state{ ASSET_QUEUED };
+    bool done = false;              // main thread: already uploaded or reported as failed
+
+    SDL_Surface* surface = nullptr; // decoded pixels, uploaded and freed on the main thread
+    std::vector<char> fileData;     // fonts are only read on a worker; FreeType stays on the main thread
+    const PackEntry* packed = nullptr; // set when the data comes straight from the mapped pack
+    SDL_Texture* texture = nullptr;
+    TTF_Font* font = nullptr;
+    Mix_Chunk* chunk = nullptr;
+    Mix_Music* music = nullptr;
+
+    double decodeMs = 0.0;
+    double uploadMs = 0.0;
+};
+
+// Decodes images and audio on a pool of worker threads; the GPU upload (and anything else
+// that must run on the render thread) happens in PumpAssets. Assets are handed out in the
+// order they were queued, so queue the critical ones first. With a pack set, assets found
+// in it skip decoding and are read in place; anything missing falls back to the loose file.
+struct AssetLoader {
+    const AssetPack* pack = nullptr;
+    std::vector<std::unique_ptr<Asset>> assets;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next{ 0 };
+    Uint64 startCounter = 0;
+    size_t pending = 0;
+};
+
+int QueueAsset(AssetLoader& loader, const std::string& path, AssetKind kind, bool critical, int fontSize = 0);
+void StartAssetLoader(AssetLoader& loader, int threadCount);
+// Main thread: uploads whatever the workers finished since the last call. Returns false if
+// a critical asset failed to load.
+bool PumpAssets(AssetLoader& loader, SDL_Renderer* renderer);
+// Main thread: pumps until every critical asset is ready; non-critical ones keep streaming
+bool WaitForCriticalAssets(AssetLoader& loader, SDL_Renderer* renderer);
+bool AssetsPending(const AssetLoader& loader);
+// Joins the workers and frees everything the loader produced
+void DestroyAssets(AssetLoader& loader);
+
+// Null until the asset is ready (or if it failed)
+SDL_Texture* GetTexture(const AssetLoader& loader, int id);
+TTF_Font* GetFont(const AssetLoader& loader, int id);
+Mix_Chunk* GetChunk(const AssetLoader& loader, int id);
+Mix_Music* GetMusic(const AssetLoader& loader, int id);
@@ -0,0 +1,95 @@
+#include "AssetPack.h"
+#include <cstring>
+#include <iostream>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool MapFile(AssetPack& pack, const char* path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    pack.file = file;
+    pack.mapping = mapping;
+    pack.data = (const Uint8*)view;
+    pack.size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // the mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    pack.data = (const Uint8*)view;
+    pack.size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+bool OpenAssetPack(AssetPack& pack, const char* path) {
+    if (!MapFile(pack, path)) return false;
+
+    const PackHeader* header = (const PackHeader*)pack.data;
+    bool valid = pack.size >= sizeof(PackHeader) && memcmp(header->magic, packMagic, 4) == 0 &&
+                 header->version == packVersion &&
+                 header->entryCount <= (pack.size - sizeof(PackHeader)) / sizeof(PackEntry);
+    if (valid) {
+        pack.entries = (const PackEntry*)(pack.data + sizeof(PackHeader));
+        pack.entryCount = header->entryCount;
+        for (Uint32 i = 0; i < pack.entryCount && valid; i++) {
+            const PackEntry& e = pack.entries[i];
+            valid = e.offset <= pack.size && e.size <= pack.size - e.offset && e.name[sizeof(e.name) - 1] == 0;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Not a valid asset pack: " << path << std::endl;
+        CloseAssetPack(pack);
+        return false;
+    }
+    return true;
+}
+
+void CloseAssetPack(AssetPack& pack) {
+    if (!pack.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(pack.data);
+    CloseHandle(pack.mapping);
+    CloseHandle(pack.file);
+    pack.file = nullptr;
+    pack.mapping = nullptr;
+#else
+    munmap((void*)pack.data, pack.size);
+#endif
+    pack.data = nullptr;
+    pack.size = 0;
+    pack.entries = nullptr;
+    pack.entryCount = 0;
+}
+
+const PackEntry* FindPackEntry(const AssetPack& pack, const char* name) {
+    for (Uint32 i = 0; i < pack.entryCount; i++) {
+        if (strcmp(pack.entries[i].name, name) == 0) return &pack.entries[i];
+    }
+    return nullptr;
+}
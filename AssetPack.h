@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+
+// assets.pak: a header, an entry table, then 64-byte aligned blobs. The header and entries
+// are the structs below written raw, and the PCM is in the mixer's native sample order, so
+// the pack is native-endian and is built per platform by tools/PackAssets; a pack from the
+// other byte order fails the version check. Textures are stored as tightly packed RGBA32
+// rows and short sounds as raw PCM in the mixer's format, so loading is a pointer into the
+// mapped file with no decode and no copy. Files that are streamed anyway (font, music) are
+// stored as-is.
+const char packMagic[4] = { 'C', 'E', 'A', 'P' };
+const Uint32 packVersion = 1;
+const Uint32 packAlignment = 64;
+
+enum PackEntryKind { PACK_RGBA = 1, PACK_PCM = 2, PACK_FILE = 3 };
+
+struct PackHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 reserved;
+};
+
+struct PackEntry {
+    char name[56];      // path as the game asks for it, e.g. "assets/heart.png"
+    Uint32 kind;
+    Uint32 width;       // PACK_RGBA
+    Uint32 height;
+    Uint32 freq;        // PACK_PCM
+    Uint16 format;
+    Uint16 channels;
+    Uint32 reserved;
+    Uint64 offset;      // from the start of the file
+    Uint64 size;
+};
+
+// No padding in either struct, so every compiler writes and reads the same layout
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout");
+static_assert(sizeof(PackEntry) == 96, "PackEntry layout");
+
+struct AssetPack {
+    const Uint8* data = nullptr;
+    size_t size = 0;
+    const PackEntry* entries = nullptr;
+    Uint32 entryCount = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+// Maps the whole archive read-only; the pointers it hands out live until CloseAssetPack
+bool OpenAssetPack(AssetPack& pack, const char* path);
+void CloseAssetPack(AssetPack& pack);
+const PackEntry* FindPackEntry(const AssetPack& pack, const char* name);
+inline const Uint8* PackEntryData(const AssetPack& pack, const PackEntry& entry) { return pack.data + entry.offset; }
@@ -0,0 +1,99 @@
+#include "EntityStore.h"
+#include <cmath>
+
+EntityHandle AddEntity(EntityStore& store, float x, float y, float w, float h, float vx, float vy, Uint8 type) {
+    Uint32 s;
+    if (!store.freeSlots.empty()) {
+        s = store.freeSlots.back();
+        store.freeSlots.pop_back();
+    } else {
+        s = (Uint32)store.slotDense.size();
+        store.slotDense.push_back(0);
+        store.slotGeneration.push_back(0);
+    }
+    store.slotDense[s] = (Uint32)store.x.size();
+
+    store.x.push_back(x);
+    store.y.push_back(y);
+    store.prevX.push_back(x);
+    store.prevY.push_back(y);
+    store.vx.push_back(vx);
+    store.vy.push_back(vy);
+    store.w.push_back(w);
+    store.h.push_back(h);
+    store.type.push_back(type);
+    store.slot.push_back(s);
+    return { s, store.slotGeneration[s] };
+}
+
+template <typename T>
+static void SwapAndPop(std::vector<T>& v, size_t index) {
+    v[index] = v.back();
+    v.pop_back();
+}
+
+void RemoveEntity(EntityStore& store, size_t index) {
+    Uint32 s = store.slot[index];
+    store.slotGeneration[s]++;
+    store.freeSlots.push_back(s);
+
+    size_t last = store.x.size() - 1;
+    if (index != last) store.slotDense[store.slot[last]] = (Uint32)index;
+    SwapAndPop(store.x, index);
+    SwapAndPop(store.y, index);
+    SwapAndPop(store.prevX, index);
+    SwapAndPop(store.prevY, index);
+    SwapAndPop(store.vx, index);
+    SwapAndPop(store.vy, index);
+    SwapAndPop(store.w, index);
+    SwapAndPop(store.h, index);
+    SwapAndPop(store.type, index);
+    SwapAndPop(store.slot, index);
+}
+
+void ClearEntities(EntityStore& store) {
+    for (Uint32 s : store.slot) {
+        store.slotGeneration[s]++;
+        store.freeSlots.push_back(s);
+    }
+    store.x.clear();
+    store.y.clear();
+    store.prevX.clear();
+    store.prevY.clear();
+    store.vx.clear();
+    store.vy.clear();
+    store.w.clear();
+    store.h.clear();
+    store.type.clear();
+    store.slot.clear();
+}
+
+void ReserveEntities(EntityStore& store, size_t capacity) {
+    store.x.reserve(capacity);
+    store.y.reserve(capacity);
+    store.prevX.reserve(capacity);
+    store.prevY.reserve(capacity);
+    store.vx.reserve(capacity);
+    store.vy.reserve(capacity);
+    store.w.reserve(capacity);
+    store.h.reserve(capacity);
+    store.type.reserve(capacity);
+    store.slot.reserve(capacity);
+    store.slotDense.reserve(capacity);
+    store.slotGeneration.reserve(capacity);
+    store.freeSlots.reserve(capacity);
+}
+
+EntityHandle GetHandle(const EntityStore& store, size_t index) {
+    Uint32 s = store.slot[index];
+    return { s, store.slotGeneration[s] };
+}
+
+int FindEntity(const EntityStore& store, EntityHandle handle) {
+    if (handle.slot >= store.slotGeneration.size() || store.slotGeneration[handle.slot] != handle.generation) return -1;
+    return (int)store.slotDense[handle.slot];
+}
+
+SDL_Rect EntityRect(const EntityStore& store, size_t index) {
+    return { (int)floorf(store.x[index]), (int)floorf(store.y[index]), (int)store.w[index], (int)store.h[index] };
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Refers to an entity across frames; goes stale once the entity is removed
+struct EntityHandle {
+    Uint32 slot = 0xFFFFFFFFu;
+    Uint32 generation = 0;
+};
+
+// Structure-of-arrays entity storage. Live entities are packed at [0, count) in every
+// array, so update loops walk contiguous floats. Removal swaps the last entity into the
+// hole (O(1)); handles go through the slot table so they survive that reordering.
+struct EntityStore {
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY; // position at the previous tick, for render interpolation
+    std::vector<float> vx, vy;
+    std::vector<float> w, h;
+    std::vector<Uint8> type;
+    std::vector<Uint32> slot;        // dense index -> slot
+
+    std::vector<Uint32> slotDense;   // slot -> dense index
+    std::vector<Uint32> slotGeneration;
+    std::vector<Uint32> freeSlots;
+};
+
+inline size_t EntityCount(const EntityStore& store) { return store.x.size(); }
+
+EntityHandle AddEntity(EntityStore& store, float x, float y, float w, float h, float vx, float vy, Uint8 type);
+void RemoveEntity(EntityStore& store, size_t index);
+void ClearEntities(EntityStore& store);
+void ReserveEntities(EntityStore& store, size_t capacity);
+EntityHandle GetHandle(const EntityStore& store, size_t index);
+// Dense index of a live entity, or -1 if the handle is stale
+int FindEntity(const EntityStore& store, EntityHandle handle);
+SDL_Rect EntityRect(const EntityStore& store, size_t index);
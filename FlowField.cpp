@@ -0,0 +1,205 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Separation: a chaser is pushed away from the middle of its 3x3 neighbourhood, by its offset
+// in cells, times how crowded the neighbourhood is: (enemies - 1) / separationCrowd, capped at
+// separationMaxCrowding. The pull toward the player has length 1, so a crowd packs in until
+// the push balances it instead of collapsing onto one point.
+const float separationWeight = 1.0f;
+const float separationCrowd = 4.0f;
+const float separationMaxCrowding = 4.0f;
+
+// Neighbour order for the search and for picking the next cell; straight moves come first
+static const int stepX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int stepY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+void InitFlowField(FlowField& field, int arenaW, int arenaH) {
+    field.arenaW = arenaW;
+    field.arenaH = arenaH;
+    field.cols = (int)ceilf(arenaW / flowCellSize);
+    field.rows = (int)ceilf(arenaH / flowCellSize);
+    size_t cells = (size_t)field.cols * field.rows;
+    field.cells.assign(cells, FlowCell());
+    field.blocked.assign(cells, 0);
+    field.blockedCount = 0;
+    field.distance.assign(cells, flowUnreachable);
+    field.queue.reserve(cells);
+    field.crowd.assign(cells, CrowdTally());
+    field.block.assign(cells, CrowdTally());
+    field.goalCell = -1;
+    field.dirty = true;
+}
+
+void BlockFlowRect(FlowField& field, SDL_Rect rect) {
+    if (rect.w <= 0 || rect.h <= 0) return;
+    int col0, row0, col1, row1;
+    FlowCellAt(field, (float)rect.x, (float)rect.y, col0, row0);
+    FlowCellAt(field, (float)(rect.x + rect.w - 1), (float)(rect.y + rect.h - 1), col1, row1);
+    for (int row = row0; row <= row1; row++) {
+        for (int col = col0; col <= col1; col++) {
+            Uint8& cell = field.blocked[row * field.cols + col];
+            if (!cell) field.blockedCount++;
+            cell = 1;
+        }
+    }
+    field.dirty = true;
+}
+
+// A diagonal move between two open cells may not cut the corner of a blocked one
+static bool CanStep(const FlowField& field, int col, int row, int k) {
+    int nextCol = col + stepX[k], nextRow = row + stepY[k];
+    if (nextCol < 0 || nextRow < 0 || nextCol >= field.cols || nextRow >= field.rows) return false;
+    if (field.blocked[nextRow * field.cols + nextCol]) return false;
+    if (k >= 4 && (field.blocked[row * field.cols + nextCol] || field.blocked[nextRow * field.cols + col])) return false;
+    return true;
+}
+
+// Bresenham walk between two cells, with the same corner rule as the search
+static bool ClearLine(const FlowField& field, int from, int to) {
+    int x = from % field.cols, y = from / field.cols;
+    int x1 = to % field.cols, y1 = to / field.cols;
+    int dx = abs(x1 - x), dy = abs(y1 - y);
+    int sx = x < x1 ? 1 : -1, sy = y < y1 ? 1 : -1;
+    int err = dx - dy;
+    for (;;) {
+        if (field.blocked[y * field.cols + x]) return false;
+        if (x == x1 && y == y1) return true;
+        int e2 = 2 * err;
+        bool moveX = e2 > -dy, moveY = e2 < dx;
+        if (moveX && moveY && (field.blocked[y * field.cols + x + sx] || field.blocked[(y + sy) * field.cols + x])) {
+            return false;
+        }
+        if (moveX) {
+            err -= dy;
+            x += sx;
+        }
+        if (moveY) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+bool UpdateFlowField(FlowField& field, float targetX, float targetY) {
+    int goal = FlowCellAt(field, targetX, targetY);
+    if (!field.dirty && goal == field.goalCell) return false;
+    field.goalCell = goal;
+    field.dirty = false;
+
+    std::fill(field.distance.begin(), field.distance.end(), flowUnreachable);
+    field.queue.clear();
+    field.distance[goal] = 0;
+    field.queue.push_back(goal);
+    for (size_t head = 0; head < field.queue.size(); head++) {
+        int cell = field.queue[head];
+        int col = cell % field.cols, row = cell / field.cols;
+        for (int k = 0; k < 8; k++) {
+            if (!CanStep(field, col, row, k)) continue;
+            int next = (row + stepY[k]) * field.cols + col + stepX[k];
+            if (field.distance[next] != flowUnreachable) continue;
+            field.distance[next] = field.distance[cell] + 1;
+            field.queue.push_back(next);
+        }
+    }
+
+    // Cells the search never reached have no path; heading straight for the player is all they can do
+    for (FlowCell& cell : field.cells) cell.aimsAtTarget = 1;
+    // With nothing in the way every cell sees the goal, and no waypoint is needed
+    if (field.blockedCount == 0) return true;
+    for (int cell : field.queue) {
+        if (cell == goal || ClearLine(field, cell, goal)) continue;
+        int col = cell % field.cols, row = cell / field.cols;
+        int best = -1;
+        for (int k = 0; k < 8; k++) {
+            if (!CanStep(field, col, row, k)) continue;
+            int next = (row + stepY[k]) * field.cols + col + stepX[k];
+            if (best < 0 || field.distance[next] < field.distance[best]) best = next;
+        }
+        FlowCell& flow = field.cells[cell];
+        flow.aimsAtTarget = 0;
+        flow.waypointX = (best % field.cols + 0.5f) * flowCellSize;
+        flow.waypointY = (best / field.cols + 0.5f) * flowCellSize;
+    }
+    return true;
+}
+
+void CountCrowd(FlowField& field, const float* x, const float* y, const float* w, const float* h, size_t n) {
+    int cols = field.cols, rows = field.rows;
+    std::fill(field.crowd.begin(), field.crowd.end(), CrowdTally());
+    // Offsets from the cell center rather than positions, so big crowds keep float precision
+    for (size_t i = 0; i < n; i++) {
+        float cx = x[i] + w[i] * 0.5f, cy = y[i] + h[i] * 0.5f;
+        int col, row;
+        CrowdTally& tally = field.crowd[FlowCellAt(field, cx, cy, col, row)];
+        tally.count += 1.0f;
+        tally.x += cx - (col + 0.5f) * flowCellSize;
+        tally.y += cy - (row + 0.5f) * flowCellSize;
+    }
+
+    // Each cell's neighbourhood, so chasers on either side of a cell border still see each
+    // other: a 3x3 box sum, done as a pass along the rows and one down the columns. A
+    // neighbour's offsets shift by one cell size to be relative to this cell.
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int cell = row * cols + col;
+            CrowdTally sum = field.crowd[cell];
+            if (col > 0) {
+                const CrowdTally& left = field.crowd[cell - 1];
+                sum.count += left.count;
+                sum.x += left.x - left.count * flowCellSize;
+                sum.y += left.y;
+            }
+            if (col + 1 < cols) {
+                const CrowdTally& right = field.crowd[cell + 1];
+                sum.count += right.count;
+                sum.x += right.x + right.count * flowCellSize;
+                sum.y += right.y;
+            }
+            field.block[cell] = sum;
+        }
+    }
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int cell = row * cols + col;
+            CrowdTally sum = field.block[cell];
+            if (row > 0) {
+                const CrowdTally& up = field.block[cell - cols];
+                sum.count += up.count;
+                sum.x += up.x;
+                sum.y += up.y - up.count * flowCellSize;
+            }
+            if (row + 1 < rows) {
+                const CrowdTally& down = field.block[cell + cols];
+                sum.count += down.count;
+                sum.x += down.x;
+                sum.y += down.y + down.count * flowCellSize;
+            }
+            // push = (center - cell center - mean offset) * scale, folded into one multiply-add
+            FlowCell& flow = field.cells[cell];
+            if (sum.count > 1.0f) {
+                float crowding = std::min((sum.count - 1.0f) / separationCrowd, separationMaxCrowding);
+                flow.pushScale = separationWeight * crowding / flowCellSize;
+                flow.pushBaseX = -((col + 0.5f) * flowCellSize + sum.x / sum.count) * flow.pushScale;
+                flow.pushBaseY = -((row + 0.5f) * flowCellSize + sum.y / sum.count) * flow.pushScale;
+            } else {
+                // A lone enemy is its own neighbourhood and gets no push
+                flow.pushScale = flow.pushBaseX = flow.pushBaseY = 0.0f;
+            }
+        }
+    }
+}
+
+void SteerFromField(const FlowField& field, const float* x, const float* y, const float* w, const float* h,
+                    size_t begin, size_t end, float targetX, float targetY,
+                    float* aimX, float* aimY, float* pushX, float* pushY) {
+    for (size_t i = begin; i < end; i++) {
+        float cx = x[i] + w[i] * 0.5f, cy = y[i] + h[i] * 0.5f;
+        const FlowCell& flow = field.cells[FlowCellAt(field, cx, cy)];
+        aimX[i] = flow.aimsAtTarget ? targetX : flow.waypointX;
+        aimY[i] = flow.aimsAtTarget ? targetY : flow.waypointY;
+        pushX[i] = cx * flow.pushScale + flow.pushBaseX;
+        pushY[i] = cy * flow.pushScale + flow.pushBaseY;
+    }
+}
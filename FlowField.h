@@ -0,0 +1,68 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Shared steering for chasers. A breadth-first search from the player's cell over a coarse
+// grid gives every cell the way to the player, so an enemy steers with one lookup however
+// long its path, and the cost follows the grid size rather than the enemy count. The search
+// only reruns when the player changes cells or the obstacles change.
+//
+// A cell with a clear straight line to the player's cell aims at the player itself; any other
+// cell aims at the center of its next cell on the path around the blocked cells.
+// A per-cell crowd tally adds a separation push, so chasers spread out instead of stacking.
+
+const float flowCellSize = 32.0f;
+const Uint16 flowUnreachable = 0xFFFF;
+
+// What steering reads for an enemy in a cell, packed so one lookup touches one cache line
+struct FlowCell {
+    float waypointX, waypointY;     // where to head unless aimsAtTarget
+    float pushScale;                // separation push = enemy center * pushScale + pushBase
+    float pushBaseX, pushBaseY;
+    Uint32 aimsAtTarget;            // a clear line to the player's cell, or no path at all
+};
+
+// Enemies counted in a cell, or its 3x3 block, and the sum of their offsets from the cell center
+struct CrowdTally {
+    float count, x, y;
+};
+
+struct FlowField {
+    int cols = 0, rows = 0;
+    int arenaW = 0, arenaH = 0;
+    std::vector<FlowCell> cells;
+    std::vector<Uint8> blocked;
+    int blockedCount = 0;
+    std::vector<Uint16> distance;   // cells to the goal cell; flowUnreachable if there is no path
+    std::vector<int> queue;         // search scratch
+    int goalCell = -1;
+    bool dirty = true;
+    std::vector<CrowdTally> crowd, block;
+};
+
+// Sizes the grid for the arena; clears obstacles
+void InitFlowField(FlowField& field, int arenaW, int arenaH);
+// Marks every cell the rect touches as impassable
+void BlockFlowRect(FlowField& field, SDL_Rect rect);
+// Reruns the search if the target moved to another cell or the obstacles changed; returns whether it did
+bool UpdateFlowField(FlowField& field, float targetX, float targetY);
+// Tallies entity centers per cell and sets each cell's separation push; call once per tick before steering
+void CountCrowd(FlowField& field, const float* x, const float* y, const float* w, const float* h, size_t n);
+// For entities [begin, end): where each should head and how hard its neighbours push it away
+void SteerFromField(const FlowField& field, const float* x, const float* y, const float* w, const float* h,
+                    size_t begin, size_t end, float targetX, float targetY,
+                    float* aimX, float* aimY, float* pushX, float* pushY);
+
+// Grid column and row of a point, clamped so off-arena points land in the border cells
+inline int FlowCellAt(const FlowField& field, float x, float y, int& col, int& row) {
+    col = (int)(x * (1.0f / flowCellSize));
+    row = (int)(y * (1.0f / flowCellSize));
+    col = col < 0 ? 0 : (col >= field.cols ? field.cols - 1 : col);
+    row = row < 0 ? 0 : (row >= field.rows ? field.rows - 1 : row);
+    return row * field.cols + col;
+}
+
+inline int FlowCellAt(const FlowField& field, float x, float y) {
+    int col, row;
+    return FlowCellAt(field, x, y, col, row);
+}
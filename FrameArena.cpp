@@ -0,0 +1,61 @@
+#include "FrameArena.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdint>
+#include <new>
+
+// Extra room past the last peak, so a frame slightly bigger than any before still fits
+const size_t arenaSlack = 4096;
+const size_t blockAlign = 64;
+
+// Heap memory comes from operator new, so the allocation counter sees every block and spill
+static Uint8* AlignUp(void* p, size_t align) {
+    return (Uint8*)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void* ArenaAlloc(FrameArena& arena, size_t bytes, size_t align) {
+    arena.frameBytes += bytes + align;
+    size_t offset = (arena.used + align - 1) & ~(align - 1);
+    if (arena.block && offset + bytes <= arena.capacity) {
+        arena.used = offset + bytes;
+        return arena.block + offset;
+    }
+    void* p = ::operator new(bytes + align);
+    arena.spills.push_back(p);
+    arena.spillCount++;
+    return AlignUp(p, align);
+}
+
+void ResetArena(FrameArena& arena) {
+    for (void* p : arena.spills) ::operator delete(p);
+    arena.spills.clear();
+    if (arena.frameBytes > arena.capacity) {
+        ::operator delete(arena.storage);
+        arena.capacity = arena.frameBytes + arenaSlack;
+        arena.storage = ::operator new(arena.capacity + blockAlign);
+        arena.block = AlignUp(arena.storage, blockAlign);
+    }
+    arena.used = 0;
+    arena.frameBytes = 0;
+}
+
+void DestroyArena(FrameArena& arena) {
+    ResetArena(arena);
+    ::operator delete(arena.storage);
+    arena.storage = nullptr;
+    arena.block = nullptr;
+    arena.capacity = 0;
+}
+
+const char* ArenaFormat(FrameArena& arena, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list sizing;
+    va_copy(sizing, args);
+    int length = vsnprintf(nullptr, 0, format, sizing);
+    va_end(sizing);
+    char* text = length < 0 ? nullptr : static_cast<char*>(ArenaAlloc(arena, (size_t)length + 1, 1));
+    if (text) vsnprintf(text, (size_t)length + 1, format, args);
+    va_end(args);
+    return text ? text : "";
+}
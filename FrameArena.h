@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Bump allocator for data that lives one frame (or one tick): every allocation is a pointer
+// bump in one block, and ResetArena frees them all at once. A frame that outgrows the block
+// spills to the heap; the next reset grows the block to that frame's total, so each new
+// peak allocates once and steady-state frames never touch the heap.
+struct FrameArena {
+    void* storage = nullptr;
+    Uint8* block = nullptr;         // storage, aligned to a cache line
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t frameBytes = 0;          // everything asked for since the reset, spills included
+    std::vector<void*> spills;
+    Uint32 spillCount = 0;          // allocations that missed the block, over the arena's life
+};
+
+void* ArenaAlloc(FrameArena& arena, size_t bytes, size_t align = 16);
+// Invalidates everything allocated since the last reset
+void ResetArena(FrameArena& arena);
+void DestroyArena(FrameArena& arena);
+// printf into the arena; the string lives until the next reset
+const char* ArenaFormat(FrameArena& arena, const char* format, ...);
+
+// Uninitialised array of n trivially copyable values
+template <typename T>
+T* ArenaArray(FrameArena& arena, size_t n) {
+    return static_cast<T*>(ArenaAlloc(arena, n * sizeof(T), alignof(T) > 16 ? alignof(T) : 16));
+}
@@ -0,0 +1,56 @@
+#include "FramePacer.h"
+#include <algorithm>
+
+// Bounds for the spin, as fractions of a second: the least kept for the wakeup jitter, and
+// the most a bad wakeup may ever cost in busy waiting
+const double minSpinSeconds = 0.0005;
+const double maxSpinSeconds = 0.004;
+
+void InitFramePacer(FramePacer& pacer, int hz, bool vsync) {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    pacer.period = frequency / (Uint64)std::max(hz, 1);
+    pacer.spinMargin = (Uint64)(frequency * 0.002);
+    pacer.vsync = vsync;
+    pacer.frames = 0;
+    pacer.missed = 0;
+    pacer.worstLateMs = 0.0;
+    ResetFramePacer(pacer);
+}
+
+void ResetFramePacer(FramePacer& pacer) {
+    pacer.deadline = SDL_GetPerformanceCounter() + pacer.period;
+}
+
+void WaitForNextFrame(FramePacer& pacer) {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+    pacer.frames++;
+    // Vsync frames are allowed half a refresh of slack before counting as late
+    Uint64 lateAfter = pacer.vsync ? pacer.deadline + pacer.period / 2 : pacer.deadline;
+    if (now > lateAfter) {
+        pacer.missed++;
+        pacer.worstLateMs = std::max(pacer.worstLateMs, (double)(now - pacer.deadline) * 1000.0 / frequency);
+        pacer.deadline = now + pacer.period;
+        return;
+    }
+    if (pacer.vsync) {
+        pacer.deadline = now + pacer.period;
+        return;
+    }
+
+    if (pacer.deadline - now > pacer.spinMargin) {
+        Uint32 sleepMs = (Uint32)((pacer.deadline - now - pacer.spinMargin) * 1000 / frequency);
+        if (sleepMs > 0) {
+            SDL_Delay(sleepMs);
+            // Spin for at least as long as this sleep overshot, easing back down when wakeups are punctual
+            Uint64 woke = SDL_GetPerformanceCounter();
+            Uint64 expected = now + (Uint64)sleepMs * frequency / 1000;
+            Uint64 overshoot = woke > expected ? woke - expected : 0;
+            pacer.spinMargin = std::max(overshoot + (Uint64)(frequency * minSpinSeconds), pacer.spinMargin - pacer.spinMargin / 16);
+            pacer.spinMargin = std::min(pacer.spinMargin, (Uint64)(frequency * maxSpinSeconds));
+        }
+    }
+    while (SDL_GetPerformanceCounter() < pacer.deadline) {
+    }
+    pacer.deadline += pacer.period;
+}
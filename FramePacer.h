@@ -0,0 +1,26 @@
+#pragma once
+#include <SDL.h>
+
+// Paces the render loop to a target refresh rate. It sleeps until just short of each frame's
+// deadline, then spins on the performance counter for the rest, so frames land on time even
+// where SDL_Delay wakes a millisecond or more late. A frame that runs past its deadline counts
+// as missed, and the next deadline restarts from now instead of rushing to catch up.
+//
+// With vsync the present call already waits for the display, so the pacer never sleeps and
+// only counts frames that took longer than one refresh.
+
+struct FramePacer {
+    Uint64 period = 0;          // performance counter ticks per frame
+    Uint64 deadline = 0;        // when the current frame should be done
+    Uint64 spinMargin = 0;      // left to spin after sleeping; follows how late SDL_Delay wakes
+    bool vsync = false;
+    Uint32 frames = 0;
+    Uint32 missed = 0;
+    double worstLateMs = 0.0;
+};
+
+void InitFramePacer(FramePacer& pacer, int hz, bool vsync);
+// Ends a frame: waits out the rest of it and sets the next deadline
+void WaitForNextFrame(FramePacer& pacer);
+// After the loop sat idle, so the next frame gets a full period and is not counted late
+void ResetFramePacer(FramePacer& pacer);
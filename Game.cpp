@@ -0,0 +1,650 @@
+#include "Game.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "JobSystem.h"
+#include "Leaderboard.h"
+#include "SweptCollision.h"
+
+GameState gameState = MENU;
+int score = 0;
+int lives = 3;
+int level = 1;
+int highScore = 0;
+float playerX = 368.0f, playerY = 300.0f;
+float playerPrevX = 368.0f, playerPrevY = 300.0f;
+SDL_Rect playerRect = { 368,300,64,64 };
+SDL_Rect itemRect = { 400,400,32,32 };
+const float playerSpeed = 300.0f;
+Uint8 heldMoveKeys = 0;
+
+Uint32 gameStartTime = 0;
+int timeLimit = 30;
+
+EntityStore enemies;
+int enemiesPerLevel = 2;
+WaveTable waveTable = DefaultWaveTable();
+
+bool isInvulnerable = false;
+const int invulnerableDuration = 1000; //ms
+
+int currentWave = 1;
+int enemiesToSpawn = 0;
+bool waveInProgress = false;
+Uint32 waveStartTime = 0;
+Uint32 waveDuration = 0; //ms
+
+ProjectilePool projectilePool;
+EntityStore& projectiles = projectilePool.store;
+
+Scheduler gameEvents;
+
+const size_t simChunkSize = 1024;
+
+SpatialGrid enemyGrid;
+SpatialGrid projectileGrid;
+FlowField enemyFlow;
+std::vector<int> gridHits;
+FrameArena tickArena;
+
+const int simTickRate = 60;
+const float simDt = 1.0f / simTickRate;
+GameClock simClock = { 0, simTickRate };
+Rng gameRng;
+
+bool persistHighScore = true;
+void (*gameSoundHook)(GameSound sound) = nullptr;
+
+static void PlayGameSound(GameSound sound) {
+    if (gameSoundHook) gameSoundHook(sound);
+}
+
+Uint32 SimTimeMs() {
+    return ClockMs(simClock);
+}
+
+const char* const highScorePath = "score.txt";
+const Uint32 highScoreFlushInterval = 5000; //ms
+
+void LoadHighScore() {
+    Leaderboard board;
+    LoadLeaderboard(board, highScorePath);
+    highScore = board.count > 0 ? board.entries[0].score : 0;
+    if (persistHighScore) StartScoreWriter(highScorePath, board, highScoreFlushInterval);
+}
+
+void CloseHighScore() {
+    StopScoreWriter();
+}
+
+// Score the score writer last heard about; a new game starts from 0 with nothing to post
+static int postedScore = 0;
+
+// Called whenever score changes. Only raises the best score: the run itself goes to the
+// writer once per tick, in PostRunIfChanged, so a wave leaving the arena takes the writer's
+// mutex once rather than once per enemy.
+static void UpdateHighScore() {
+    if (score > highScore) highScore = score;
+}
+
+// The writer thread coalesces these, so no file I/O here
+static void PostRunIfChanged() {
+    if (!persistHighScore || score == postedScore) return;
+    postedScore = score;
+    ScoreEntry run;
+    run.score = score;
+    run.wave = currentWave;
+    run.seconds = (int)((SimTimeMs() - gameStartTime) / 1000);
+    PostCurrentRun(run);
+}
+
+static void EndGame(GameState result) {
+    PlayGameSound(result == VICTORY ? SOUND_VICTORY : SOUND_GAMEOVER);
+    gameState = result;
+    PostRunIfChanged();
+    CommitCurrentRun();
+}
+
+static void StartInvulnerability(Uint32 now) {
+    isInvulnerable = true;
+    ScheduleEvent(gameEvents, now + invulnerableDuration, EVENT_INVULNERABLE_END);
+}
+
+// Room for the projectiles already in flight, which outlive the wave that fired them,
+// plus everything the live shooters can have in the air at once
+static void ReserveProjectilesForShooters() {
+    size_t capacity = EntityCount(projectiles);
+    for (int t = 0; t < waveTable.archetypeCount; t++) {
+        const EnemyArchetype& a = waveTable.archetypes[t];
+        if (a.fireInterval == 0) continue;
+        int shooters = (int)std::count(enemies.type.begin(), enemies.type.end(), (Uint8)t);
+        capacity += ProjectileCapacityForWave(shooters, a.fireInterval, a.bulletSpeed, 800, 600);
+    }
+    ReservePool(projectilePool, capacity);
+}
+
+static FileWatch waveFile;
+std::string waveSource;
+// A loaded table that drops archetypes, held back until the next wave starts
+static WaveTable pendingWaveTable;
+static std::string pendingWaveSource;
+static bool wavesPending = false;
+
+bool LoadWaveFile(const char* path) {
+    waveFile.path = path;
+    FileChanged(waveFile);
+    std::string error, source;
+    WaveTable table = {};
+    if (!LoadWaveTable(path, table, error, &source)) {
+        std::cerr << "waves: " << path << ": " << error << ", keeping the current table" << std::endl;
+        return false;
+    }
+    // Live enemies of a dropped archetype would index past the table, so the table waits
+    // for the next wave, which starts with no enemies and copies its row from it
+    if (table.archetypeCount < waveTable.archetypeCount && EntityCount(enemies) > 0) {
+        pendingWaveTable = table;
+        pendingWaveSource = source;
+        wavesPending = true;
+        std::cout << "waves: " << path << " drops archetypes, applying it from the next wave" << std::endl;
+        return true;
+    }
+    waveTable = table;
+    waveSource = source;
+    wavesPending = false;
+    // A faster fire rate or slower bullets for live shooters need more room in flight
+    ReserveProjectilesForShooters();
+    return true;
+}
+
+void PollWaveFile() {
+    if (waveFile.path.empty() || !FileChanged(waveFile)) return;
+    // Archetype changes apply at once, wave rows from the next wave
+    if (LoadWaveFile(waveFile.path.c_str())) std::cout << "waves: reloaded " << waveFile.path << std::endl;
+}
+
+bool SetWaveSource(const std::string& source) {
+    WaveTable table = DefaultWaveTable();
+    std::string error;
+    if (!source.empty() && !ParseWaveTable(source.c_str(), table, error)) {
+        std::cerr << "waves: " << error << ", keeping the current table" << std::endl;
+        return false;
+    }
+    waveTable = table;
+    waveSource = source;
+    wavesPending = false;
+    waveFile.path.clear();
+    return true;
+}
+
+// The wave row SpawnEnemy draws from; a copy, so a reload cannot pull it out from under a wave
+static WaveDef spawnWave = DefaultWaveTable().waves[0];
+
+void SpawnEnemy(int screenW, int screenH) {
+    // Positions leave room for the largest archetype the wave can pick
+    float maxW = 0.0f, maxH = 0.0f;
+    for (int t = 0; t < waveTable.archetypeCount; t++) {
+        if (spawnWave.weights[t] == 0) continue;
+        maxW = std::max(maxW, waveTable.archetypes[t].w);
+        maxH = std::max(maxH, waveTable.archetypes[t].h);
+    }
+    float x = (float)RandomInt(gameRng, screenW - (int)maxW);
+    float y = (float)RandomInt(gameRng, screenH - (int)maxH);
+    int roll = RandomInt(gameRng, spawnWave.totalWeight);
+    int type = 0;
+    while (type < waveTable.archetypeCount - 1 && roll >= spawnWave.weights[type]) roll -= spawnWave.weights[type++];
+    const EnemyArchetype& archetype = waveTable.archetypes[type];
+    float angle = RandomInt(gameRng, 360) * 3.14159f / 180.0f;
+    AddEntity(enemies, x, y, archetype.w, archetype.h, cosf(angle) * archetype.speed, sinf(angle) * archetype.speed, (Uint8)type);
+}
+
+// Side effects a chunk found in its own entity range; merged on the calling thread in chunk order
+struct ChunkResult {
+    std::vector<Uint32> removed;    // ascending entity indices
+};
+static std::vector<ChunkResult> chunkResults;
+const Uint32 noEntity = 0xFFFFFFFFu;
+
+static void PrepareChunkResults(size_t count) {
+    size_t chunks = ChunkCount(count, simChunkSize);
+    if (chunkResults.size() < chunks) chunkResults.resize(chunks);
+    for (size_t c = 0; c < chunks; c++) chunkResults[c].removed.clear();
+}
+
+static void FireAtPlayer(size_t i, float targetX, float targetY) {
+    float x = enemies.x[i], y = enemies.y[i];
+    float w = enemies.w[i], h = enemies.h[i];
+    float dx = targetX - (x + w / 2.0f);
+    float dy = targetY - (y + h / 2.0f);
+    float lengthProjectile = sqrtf(dx * dx + dy * dy);
+    if (lengthProjectile != 0) {
+        dx /= lengthProjectile;
+        dy /= lengthProjectile;
+    }
+    float speed = waveTable.archetypes[enemies.type[i]].bulletSpeed;
+    SpawnProjectile(projectilePool, x + w / 2.0f - 4, y + h / 2.0f - 4, 8, 8, dx * speed, dy * speed);
+}
+
+static void RemoveOffscreenEnemy(size_t i) {
+    score += waveTable.archetypes[enemies.type[i]].scoreValue;
+    RemoveEntity(enemies, i);
+    UpdateHighScore();
+}
+
+void UpdateEnemies(float dt, int screenW, int screenH, SDL_Rect player) {
+    float targetX = player.x + player.w / 2.0f;
+    float targetY = player.y + player.h / 2.0f;
+    size_t count = EntityCount(enemies);
+    // Per-enemy aim points and separation pushes for ChaseKernel, filled from enemyFlow
+    float* steerAimX = ArenaArray<float>(tickArena, count);
+    float* steerAimY = ArenaArray<float>(tickArena, count);
+    float* steerPushX = ArenaArray<float>(tickArena, count);
+    float* steerPushY = ArenaArray<float>(tickArena, count);
+    Uint8* enemyOffscreen = ArenaArray<Uint8>(tickArena, count);
+    PrepareChunkResults(count);
+
+    // One search per player cell change and one crowd tally, shared by every chaser
+    if (enemyFlow.arenaW != screenW || enemyFlow.arenaH != screenH) InitFlowField(enemyFlow, screenW, screenH);
+    UpdateFlowField(enemyFlow, targetX, targetY);
+    CountCrowd(enemyFlow, enemies.x.data(), enemies.y.data(), enemies.w.data(), enemies.h.data(), count);
+
+    // Archetypes with a speed chase the player, the rest hold their position. Chunks are a
+    // multiple of the SIMD width, so every entity takes the same kernel path as in one unsplit batch.
+    float stepByType[maxArchetypes];
+    for (int t = 0; t < maxArchetypes; t++) {
+        const EnemyArchetype& a = waveTable.archetypes[t];
+        bool known = t < waveTable.archetypeCount;
+        stepByType[t] = known && a.speed > 0.0f ? (a.speed + level * waveTable.speedPerLevel) * dt : 0.0f;
+    }
+    auto update = [&](size_t chunk, size_t begin, size_t end) {
+        std::copy(enemies.x.begin() + begin, enemies.x.begin() + end, enemies.prevX.begin() + begin);
+        std::copy(enemies.y.begin() + begin, enemies.y.begin() + end, enemies.prevY.begin() + begin);
+        SteerFromField(enemyFlow, enemies.x.data(), enemies.y.data(), enemies.w.data(), enemies.h.data(), begin, end,
+                       targetX, targetY, steerAimX, steerAimY, steerPushX, steerPushY);
+        ChaseKernel(enemies.x.data() + begin, enemies.y.data() + begin, enemies.w.data() + begin, enemies.h.data() + begin,
+                    enemies.type.data() + begin, end - begin, stepByType, steerAimX + begin, steerAimY + begin,
+                    steerPushX + begin, steerPushY + begin);
+        ChunkResult& result = chunkResults[chunk];
+        for (size_t i = begin; i < end; i++) {
+            float x = enemies.x[i], y = enemies.y[i];
+            bool offscreen = x + enemies.w[i] < 0 || x > screenW || y + enemies.h[i] < 0 || y > screenH;
+            enemyOffscreen[i] = offscreen;
+            if (offscreen) result.removed.push_back((Uint32)i);
+        }
+    };
+    ParallelFor(count, simChunkSize, update);
+
+    // Merge: replays the old single pass, which walked forward swap-and-popping off-screen
+    // enemies, so a removal pulled the last enemy in and visited it next
+    size_t chunks = ChunkCount(count, simChunkSize);
+    size_t live = count;
+    for (size_t c = 0; c < chunks; c++) {
+        for (Uint32 o : chunkResults[c].removed) {
+            if (o >= live) break; // already pulled in from the tail and handled there
+            for (;;) {
+                RemoveOffscreenEnemy(o);
+                live--;
+                // Enemy `live` now sits at o
+                if (o == live || !enemyOffscreen[live]) break;
+            }
+        }
+    }
+}
+
+// Both grids hold each entity's swept bounds over the last tick, so a query with the
+// player's sweep finds everything that could have crossed it on the way
+void RebuildEnemyGrid() {
+    BeginGrid(enemyGrid);
+    for (size_t i = 0; i < EntityCount(enemies); i++) AddToGrid(enemyGrid, SweptBounds(EntitySweep(enemies, i)));
+    EndGrid(enemyGrid);
+}
+
+static SweptBox PlayerSweep() {
+    return { floorf(playerPrevX), floorf(playerPrevY), (float)playerRect.x, (float)playerRect.y,
+             (float)playerRect.w, (float)playerRect.h };
+}
+
+void UpdateProjectiles(float dt, int screenW, int screenH) {
+    size_t count = EntityCount(projectiles);
+    PrepareChunkResults(count);
+    auto integrate = [&](size_t chunk, size_t begin, size_t end) {
+        std::copy(projectiles.x.begin() + begin, projectiles.x.begin() + end, projectiles.prevX.begin() + begin);
+        std::copy(projectiles.y.begin() + begin, projectiles.y.begin() + end, projectiles.prevY.begin() + begin);
+        IntegrateKernel(projectiles.x.data() + begin, projectiles.y.data() + begin,
+                        projectiles.vx.data() + begin, projectiles.vy.data() + begin, end - begin, dt);
+        ChunkResult& result = chunkResults[chunk];
+        for (size_t i = begin; i < end; i++) {
+            SDL_Rect r = EntityRect(projectiles, i);
+            if (r.x < 0 || r.x > screenW || r.y < 0 || r.y > screenH) result.removed.push_back((Uint32)i);
+        }
+    };
+    ParallelFor(count, simChunkSize, integrate);
+
+    BeginGrid(projectileGrid);
+    for (size_t i = 0; i < count; i++) AddToGrid(projectileGrid, SweptBounds(EntitySweep(projectiles, i)));
+    EndGrid(projectileGrid);
+
+    // Only the first projectile to reach the player counts, the rest find it invulnerable
+    Uint32 hit = noEntity;
+    if (!isInvulnerable) {
+        SweptBox player = PlayerSweep();
+        gridHits.clear();
+        QueryGrid(projectileGrid, SweptBounds(player), gridHits);
+        int first = FirstSweptHit(projectiles, gridHits, player);
+        if (first >= 0) {
+            hit = (Uint32)first;
+            lives--;
+            PlayGameSound(SOUND_WRONG);
+            StartInvulnerability(SimTimeMs());
+        }
+    }
+    // Remove in descending index order so swap-and-pop only moves entries that stay
+    for (size_t c = ChunkCount(count, simChunkSize); c-- > 0;) {
+        const std::vector<Uint32>& removed = chunkResults[c].removed;
+        for (size_t k = removed.size(); k-- > 0;) {
+            if (hit != noEntity && hit >= removed[k]) {
+                if (hit > removed[k]) RemoveEntity(projectiles, hit);
+                hit = noEntity;
+            }
+            RemoveEntity(projectiles, removed[k]);
+        }
+    }
+    if (hit != noEntity) RemoveEntity(projectiles, hit);
+}
+
+void StartWave() {
+    ClearEntities(enemies);
+    if (wavesPending) {
+        waveTable = pendingWaveTable;
+        waveSource = pendingWaveSource;
+        wavesPending = false;
+    }
+    const WaveDef* wave = WaveFor(waveTable, currentWave, enemiesToSpawn);
+    if (!wave) {
+        // Only reachable by starting a wave past the end of a victory table directly
+        wave = &waveTable.waves.back();
+        enemiesToSpawn = wave->count;
+    }
+    spawnWave = *wave;
+    for (int i = 0; i < enemiesToSpawn; i++) {
+        SpawnEnemy(800, 600);
+    }
+    // Size the projectile pool for this wave's shooters now, so firing never allocates
+    ReserveProjectilesForShooters();
+    RebuildEnemyGrid();
+    waveInProgress = true;
+    waveDuration = wave->duration;
+    waveStartTime = SimTimeMs();
+    // The last wave's shooters are gone; their handles are stale, but there is no need to keep them queued
+    CancelEvents(gameEvents, EVENT_ENEMY_FIRE);
+    ScheduleFirstShots();
+    ScheduleEvent(gameEvents, waveStartTime + waveDuration, EVENT_WAVE_END);
+}
+
+// Random phases spread the shots out, so a wave does not fire in one volley
+void ScheduleFirstShots() {
+    Uint32 now = SimTimeMs();
+    for (size_t i = 0; i < EntityCount(enemies); i++) {
+        Uint32 interval = waveTable.archetypes[enemies.type[i]].fireInterval;
+        if (interval == 0) continue;
+        Uint32 delay = interval / 2 + (Uint32)RandomInt(gameRng, (int)(interval - interval / 2) + 1);
+        ScheduleEvent(gameEvents, now + delay, EVENT_ENEMY_FIRE, GetHandle(enemies, i));
+    }
+}
+
+static void EndWave() {
+    score += 20;
+    UpdateHighScore();
+    int count;
+    if (!WaveFor(waveTable, currentWave + 1, count)) {
+        EndGame(VICTORY);
+        return;
+    }
+    currentWave++;
+    StartWave();
+}
+
+// Each shooter fires and books its next shot; one removed since it was scheduled is skipped
+static void FireDue(const ScheduledEvent& event) {
+    int i = FindEntity(enemies, event.target);
+    if (i < 0) return;
+    // A reload may have turned this archetype's fire off
+    Uint32 interval = waveTable.archetypes[enemies.type[i]].fireInterval;
+    if (interval == 0) return;
+    FireAtPlayer(i, playerRect.x + playerRect.w / 2.0f, playerRect.y + playerRect.h / 2.0f);
+    // From the due time, not now, so the cadence does not drift with the tick length
+    ScheduleEvent(gameEvents, event.due + interval, EVENT_ENEMY_FIRE, event.target);
+}
+
+void RunDueEvents() {
+    Uint32 now = SimTimeMs();
+    ScheduledEvent event;
+    while (gameState == PLAYING && PopDueEvent(gameEvents, now, event)) {
+        switch (event.kind) {
+        case EVENT_ENEMY_FIRE:
+            FireDue(event);
+            break;
+        case EVENT_WAVE_END:
+            EndWave();
+            break;
+        case EVENT_INVULNERABLE_END:
+            isInvulnerable = false;
+            break;
+        }
+    }
+}
+
+void StartNewGame() {
+    gameState = PLAYING;
+    score = 0;
+    postedScore = 0;
+    lives = 3;
+    level = 1;
+    currentWave = 1;
+    isInvulnerable = false;
+    ClearEvents(gameEvents);
+    ClearEntities(projectiles);
+    ResetPoolStats(projectilePool);
+    ClearEntities(enemies);
+    StartWave();
+    gameStartTime = SimTimeMs();
+}
+
+void HandlePlayingKey(SDL_Keycode pressed) {
+    if (pressed == SDLK_p) {
+        gameState = PAUSED;
+    }
+}
+
+void PlacePlayer(float x, float y) {
+    playerX = playerPrevX = x;
+    playerY = playerPrevY = y;
+    playerRect.x = (int)floorf(x);
+    playerRect.y = (int)floorf(y);
+}
+
+void UpdatePlayer(float dt, int screenW, int screenH) {
+    playerPrevX = playerX;
+    playerPrevY = playerY;
+    float dx = 0.0f, dy = 0.0f;
+    if (heldMoveKeys & MOVE_UP) dy -= 1.0f;
+    if (heldMoveKeys & MOVE_DOWN) dy += 1.0f;
+    if (heldMoveKeys & MOVE_LEFT) dx -= 1.0f;
+    if (heldMoveKeys & MOVE_RIGHT) dx += 1.0f;
+    // Same speed on diagonals
+    if (dx != 0.0f && dy != 0.0f) {
+        dx *= 0.70710678f;
+        dy *= 0.70710678f;
+    }
+    playerX = std::min(std::max(playerX + dx * playerSpeed * dt, 0.0f), (float)(screenW - playerRect.w));
+    playerY = std::min(std::max(playerY + dy * playerSpeed * dt, 0.0f), (float)(screenH - playerRect.h));
+    playerRect.x = (int)floorf(playerX);
+    playerRect.y = (int)floorf(playerY);
+}
+
+// Pickups, hits and timers, checked every tick once everything has moved
+static void CheckPlayer() {
+    timeLimit = 30 - (level - 1) * 5;
+    if (timeLimit < 10) timeLimit = 10;
+    Uint32 now = SimTimeMs();
+    int timeLeft = timeLimit - (now - gameStartTime) / 1000;
+    if (timeLeft <= 0) {
+        EndGame(GAME_OVER);
+        return;
+    }
+
+    if (SDL_HasIntersection(&playerRect, &itemRect)) {
+        score += 10;
+        PlayGameSound(SOUND_CORRECT);
+        itemRect.x = RandomInt(gameRng, 800 - itemRect.w);
+        itemRect.y = RandomInt(gameRng, 600 - itemRect.h);
+
+        if (score % 30 == 0) {
+            level++;
+        }
+        UpdateHighScore();
+    }
+    if (!isInvulnerable) {
+        SweptBox player = PlayerSweep();
+        gridHits.clear();
+        QueryGrid(enemyGrid, SweptBounds(player), gridHits);
+        if (FirstSweptHit(enemies, gridHits, player) >= 0) {
+            lives--;
+            PlayGameSound(SOUND_WRONG);
+            StartInvulnerability(now);
+        }
+    }
+    // A projectile hit in UpdateProjectiles can also take the last life
+    if (lives <= 0) {
+        EndGame(GAME_OVER);
+        return;
+    }
+}
+
+// One fixed simulation step; only called while PLAYING so pauses freeze the game clock
+void StepSimulation() {
+    ResetArena(tickArena);
+    AdvanceClock(simClock);
+    RunDueEvents();
+    if (gameState != PLAYING) return;
+    UpdatePlayer(simDt, 800, 600);
+    {
+        ProfileScope scope(STAGE_UPDATE_ENEMIES);
+        UpdateEnemies(simDt, 800, 600, playerRect);
+        RebuildEnemyGrid();
+    }
+    {
+        ProfileScope scope(STAGE_UPDATE_PROJECTILES);
+        UpdateProjectiles(simDt, 800, 600);
+    }
+    CheckPlayer();
+    PostRunIfChanged();
+}
+
+void ResetToMenu() {
+    score = 0;
+    lives = 3;
+    level = 1;
+    ClearEntities(enemies);
+    isInvulnerable = false;
+    ClearEvents(gameEvents);
+    waveInProgress = true;
+    currentWave = 1;
+    gameState = MENU;
+}
+
+// Inputs that change game state; both live play and replays go through here
+void HandleSimEvent(const SDL_Event& event) {
+    if (event.type == moveKeysEvent) {
+        heldMoveKeys = (Uint8)event.user.code;
+        return;
+    }
+    if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
+        SDL_Point clickPoint = { event.button.x, event.button.y };
+        switch (gameState) {
+        case MENU:
+            if (SDL_PointInRect(&clickPoint, &playButtonRect)) StartNewGame();
+            break;
+        case GAME_OVER:
+        case VICTORY:
+            if (SDL_PointInRect(&clickPoint, &restartButtonRect)) ResetToMenu();
+            break;
+        default:
+            break;
+        }
+    }
+    if (event.type == SDL_KEYDOWN) {
+        switch (gameState) {
+        case PLAYING:
+            HandlePlayingKey(event.key.keysym.sym);
+            break;
+        case PAUSED:
+            if (event.key.keysym.sym == SDLK_p) {
+                gameState = PLAYING;
+            }
+            if (event.key.keysym.sym == SDLK_ESCAPE) {
+                CommitCurrentRun();
+                gameState = MENU;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool IsSimEvent(const SDL_Event& event) {
+    return event.type == SDL_KEYDOWN || event.type == moveKeysEvent ||
+           (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT);
+}
+
+Uint8 MoveKeysFromKeyboard(const Uint8* keyboardState) {
+    Uint8 keys = 0;
+    if (keyboardState[SDL_SCANCODE_W] || keyboardState[SDL_SCANCODE_UP]) keys |= MOVE_UP;
+    if (keyboardState[SDL_SCANCODE_S] || keyboardState[SDL_SCANCODE_DOWN]) keys |= MOVE_DOWN;
+    if (keyboardState[SDL_SCANCODE_A] || keyboardState[SDL_SCANCODE_LEFT]) keys |= MOVE_LEFT;
+    if (keyboardState[SDL_SCANCODE_D] || keyboardState[SDL_SCANCODE_RIGHT]) keys |= MOVE_RIGHT;
+    return keys;
+}
+
+SDL_Event MakeMoveKeysEvent(Uint8 keys) {
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = moveKeysEvent;
+    event.user.code = keys;
+    return event;
+}
+
+static void HashBytes(Uint64& h, const void* data, size_t size) {
+    const Uint8* bytes = (const Uint8*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+}
+
+// FNV-1a over everything the simulation owns, down to the float bits of every position
+Uint64 HashGameState() {
+    Uint64 h = 14695981039346656037ULL;
+    int values[] = { (int)gameState, score, lives, level, currentWave, isInvulnerable ? 1 : 0 };
+    HashBytes(h, values, sizeof(values));
+    HashBytes(h, &simClock.tick, sizeof(simClock.tick));
+    HashBytes(h, &gameRng.state, sizeof(gameRng.state));
+    float player[] = { playerX, playerY };
+    HashBytes(h, player, sizeof(player));
+    HashBytes(h, &playerRect, sizeof(playerRect));
+    HashBytes(h, &itemRect, sizeof(itemRect));
+    const EntityStore* stores[] = { &enemies, &projectiles };
+    for (const EntityStore* store : stores) {
+        size_t n = EntityCount(*store);
+        HashBytes(h, &n, sizeof(n));
+        HashBytes(h, store->x.data(), n * sizeof(float));
+        HashBytes(h, store->y.data(), n * sizeof(float));
+        HashBytes(h, store->type.data(), n);
+    }
+    for (const ScheduledEvent& event : gameEvents.heap) {
+        Uint32 timer[] = { event.due, event.sequence, event.kind };
+        HashBytes(h, timer, sizeof(timer));
+    }
+    return h;
+}
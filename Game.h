@@ -0,0 +1,128 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "EntityStore.h"
+#include "ProjectilePool.h"
+#include "SpatialGrid.h"
+#include "SimdKernels.h"
+#include "Profiler.h"
+#include "Rng.h"
+#include "GameClock.h"
+#include "WaveTable.h"
+#include "Scheduler.h"
+#include "FlowField.h"
+#include "FrameArena.h"
+
+// Game logic and state, with no window, renderer, fonts or audio; the game and the benchmark both link it
+// Archetype ids in the built-in wave table and the shipped assets/waves.txt
+enum EnemyType{SLOW, FAST, RANGED};
+// Game states
+enum GameState { MENU, PLAYING, PAUSED, GAME_OVER, VICTORY };
+// Sounds the simulation asks for; whoever owns the mixer decides how to play them
+enum GameSound { SOUND_WRONG, SOUND_GAMEOVER, SOUND_VICTORY, SOUND_CORRECT, SOUND_COUNT };
+// Movement keys held down; the input side samples them and the player moves every tick
+enum MoveKey : Uint8 { MOVE_UP = 1, MOVE_DOWN = 2, MOVE_LEFT = 4, MOVE_RIGHT = 8 };
+// Sim input carrying a new set of held MoveKeys in user.code; never goes through SDL's queue
+const Uint32 moveKeysEvent = SDL_USEREVENT;
+
+const SDL_Rect playButtonRect = { 300,250,200,60 };
+const SDL_Rect restartButtonRect = { 300,330,200,60 };
+
+extern GameState gameState;
+extern int score;
+extern int lives;
+extern int level;
+extern int highScore;
+// playerRect is the float position floored, which is what collisions use
+extern float playerX, playerY;
+extern float playerPrevX, playerPrevY;
+extern SDL_Rect playerRect;
+extern SDL_Rect itemRect;
+extern const float playerSpeed;   // pixels per second
+extern Uint8 heldMoveKeys;
+
+extern Uint32 gameStartTime;
+extern int timeLimit;
+
+extern EntityStore enemies;
+extern int enemiesPerLevel;
+extern WaveTable waveTable;
+
+extern bool isInvulnerable;
+extern const int invulnerableDuration;
+
+extern int currentWave;
+extern int enemiesToSpawn;
+extern bool waveInProgress;
+extern Uint32 waveStartTime;
+extern Uint32 waveDuration;
+
+extern ProjectilePool projectilePool;
+extern EntityStore& projectiles;
+
+// Per-enemy fire cooldowns, the end of each wave and of invulnerability; StepSimulation
+// runs whatever is due at the start of each tick
+extern Scheduler gameEvents;
+
+// Entities per job-system chunk in the update loops; a multiple of every SIMD width
+extern const size_t simChunkSize;
+
+// Broad-phase for overlap queries; ids are indices into enemies / projectiles
+extern SpatialGrid enemyGrid;
+extern SpatialGrid projectileGrid;
+// Shared chase directions and crowd separation; sized to the arena on first use
+extern FlowField enemyFlow;
+extern std::vector<int> gridHits;
+// Scratch that lives for one tick, reset at the start of StepSimulation; callers that run
+// the update functions directly (the benchmark) reset it themselves between ticks
+extern FrameArena tickArena;
+
+// Fixed-step simulation clock; game logic reads time from here, never from SDL_GetTicks
+extern const int simTickRate;
+extern const float simDt;
+extern GameClock simClock;
+// Every random draw in game logic comes from here, so a seed plus the inputs replay a session
+extern Rng gameRng;
+
+extern bool persistHighScore;
+extern void (*gameSoundHook)(GameSound sound);
+
+Uint32 SimTimeMs();
+// The best score comes from the score.txt leaderboard. With persistHighScore, a background
+// writer keeps the file up to date; each run is committed when it ends (game over, victory,
+// back to the menu, or CloseHighScore at quit).
+void LoadHighScore();
+void CloseHighScore();
+
+// Loads waves and archetypes, keeping the current table if the file is missing or invalid.
+// PollWaveFile reloads it whenever it changes on disk.
+bool LoadWaveFile(const char* path);
+void PollWaveFile();
+// The text waveTable was parsed from; empty while the built-in table is in use
+extern std::string waveSource;
+// Replaces the table with one parsed from `source` (empty for the built-in one) and stops
+// following the file; false, keeping the current table, if it does not parse
+bool SetWaveSource(const std::string& source);
+
+void PlacePlayer(float x, float y);
+void UpdatePlayer(float dt, int screenW, int screenH);
+void SpawnEnemy(int screenW, int screenH);
+void UpdateEnemies(float dt, int screenW, int screenH, SDL_Rect player);
+void RebuildEnemyGrid();
+void UpdateProjectiles(float dt, int screenW, int screenH);
+void StartWave();
+// Schedules each shooter's first shot, between half and one full fire interval from now
+void ScheduleFirstShots();
+void RunDueEvents();
+void StartNewGame();
+void HandlePlayingKey(SDL_Keycode pressed);
+void StepSimulation();
+void ResetToMenu();
+
+void HandleSimEvent(const SDL_Event& event);
+bool IsSimEvent(const SDL_Event& event);
+// WASD or the arrow keys, from SDL_GetKeyboardState
+Uint8 MoveKeysFromKeyboard(const Uint8* keyboardState);
+SDL_Event MakeMoveKeysEvent(Uint8 keys);
+Uint64 HashGameState();
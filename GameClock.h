@@ -0,0 +1,17 @@
+#pragma once
+#include <SDL.h>
+
+// Simulation time counted in fixed ticks. Game logic reads time only from a GameClock,
+// so a session is a pure function of its seed and inputs, whatever the wall clock does.
+struct GameClock {
+    Uint64 tick = 0;
+    int tickRate = 60;
+};
+
+inline Uint32 ClockMs(const GameClock& clock) {
+    return (Uint32)(clock.tick * 1000 / clock.tickRate);
+}
+
+inline void AdvanceClock(GameClock& clock) {
+    clock.tick++;
+}
@@ -0,0 +1,53 @@
+#include "GameSnapshot.h"
+
+const int freshSnapshot = 4;
+
+static void CopyEntities(EntitySnapshot& out, const EntityStore& store) {
+    out.x.assign(store.x.begin(), store.x.end());
+    out.y.assign(store.y.begin(), store.y.end());
+    out.prevX.assign(store.prevX.begin(), store.prevX.end());
+    out.prevY.assign(store.prevY.begin(), store.prevY.end());
+    out.w.assign(store.w.begin(), store.w.end());
+    out.h.assign(store.h.begin(), store.h.end());
+    out.type.assign(store.type.begin(), store.type.end());
+}
+
+void CaptureSnapshot(GameSnapshot& snapshot) {
+    snapshot.tick = simClock.tick;
+    snapshot.state = gameState;
+    snapshot.score = score;
+    snapshot.lives = lives;
+    snapshot.level = level;
+    snapshot.currentWave = currentWave;
+    snapshot.highScore = highScore;
+    int timeLeft = timeLimit - (SimTimeMs() - gameStartTime) / 1000;
+    snapshot.timeLeft = timeLeft < 0 ? 0 : timeLeft;
+    snapshot.isInvulnerable = isInvulnerable;
+    snapshot.player = playerRect;
+    snapshot.playerX = playerX;
+    snapshot.playerY = playerY;
+    snapshot.playerPrevX = playerPrevX;
+    snapshot.playerPrevY = playerPrevY;
+    snapshot.item = itemRect;
+    for (int t = 0; t < maxArchetypes; t++) snapshot.enemyColors[t] = waveTable.archetypes[t].color;
+    CopyEntities(snapshot.enemies, enemies);
+    CopyEntities(snapshot.projectiles, projectiles);
+}
+
+GameSnapshot& SnapshotWriteSlot(SnapshotBuffer& buffer) {
+    return buffer.slots[buffer.back];
+}
+
+void PublishSnapshot(SnapshotBuffer& buffer) {
+    // Release makes the slot's contents visible to the reader that picks it up
+    int previous = buffer.middle.exchange(buffer.back | freshSnapshot, std::memory_order_acq_rel);
+    buffer.back = previous & ~freshSnapshot;
+}
+
+const GameSnapshot& ReadSnapshot(SnapshotBuffer& buffer) {
+    if (buffer.middle.load(std::memory_order_relaxed) & freshSnapshot) {
+        int previous = buffer.middle.exchange(buffer.front, std::memory_order_acq_rel);
+        buffer.front = previous & ~freshSnapshot;
+    }
+    return buffer.slots[buffer.front];
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <vector>
+#include "Game.h"
+
+// What the renderer needs of an EntityStore: positions at this tick and the last one
+struct EntitySnapshot {
+    std::vector<float> x, y, prevX, prevY, w, h;
+    std::vector<Uint8> type;
+};
+
+// Everything drawn for one simulation tick. Written by the sim thread, then read-only.
+struct GameSnapshot {
+    Uint64 tick = 0;
+    Uint64 publishedAt = 0;     // performance counter when the tick finished
+    Uint32 inputsApplied = 0;   // sim inputs handled so far; compare with SimInputsQueued()
+    GameState state = MENU;
+    int score = 0, lives = 0, level = 0, currentWave = 0, highScore = 0;
+    int timeLeft = 0;
+    bool isInvulnerable = false;
+    SDL_Rect player = { 0, 0, 0, 0 };
+    float playerX = 0.0f, playerY = 0.0f, playerPrevX = 0.0f, playerPrevY = 0.0f;
+    SDL_Rect item = { 0, 0, 0, 0 };
+    EntitySnapshot enemies, projectiles;
+    SDL_Color enemyColors[maxArchetypes];   // by archetype, which the wave file can change
+};
+
+// Copies the current game state; reuses the snapshot's storage, so it stops allocating
+// once the vectors have grown to the largest wave seen
+void CaptureSnapshot(GameSnapshot& snapshot);
+
+// Lock-free triple buffer for one writer and one reader. The writer always owns a slot,
+// the reader always gets the newest published one, and neither ever waits for the other.
+struct SnapshotBuffer {
+    GameSnapshot slots[3];
+    std::atomic<int> middle{ 1 };   // slot index, | freshSnapshot once published and not yet read
+    int back = 0;                   // writer only
+    int front = 2;                  // reader only
+};
+
+GameSnapshot& SnapshotWriteSlot(SnapshotBuffer& buffer);
+void PublishSnapshot(SnapshotBuffer& buffer);
+// The newest published snapshot; valid until the reader's next call
+const GameSnapshot& ReadSnapshot(SnapshotBuffer& buffer);
@@ -0,0 +1,162 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+const int glyphCount = lastGlyph - firstGlyph + 1;
+const int atlasWidth = 512;
+const int atlasPadding = 1;
+
+bool BuildGlyphAtlas(GlyphAtlas& atlas, TTF_Font* font, SDL_Renderer* renderer) {
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* surfaces[glyphCount] = {};
+    int penX = atlasPadding, penY = atlasPadding, rowHeight = 0;
+
+    // Rasterize every glyph once and shelf-pack them left to right, top to bottom
+    for (int i = 0; i < glyphCount; i++) {
+        Uint16 ch = (Uint16)(firstGlyph + i);
+        Glyph& g = atlas.glyphs[i];
+        int advance = 0;
+        TTF_GlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+        g.advance = advance;
+        g.src = { 0, 0, 0, 0 };
+
+        surfaces[i] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!surfaces[i]) continue; // whitespace may render as nothing, it still advances
+        if (penX + surfaces[i]->w + atlasPadding > atlasWidth) {
+            penX = atlasPadding;
+            penY += rowHeight + atlasPadding;
+            rowHeight = 0;
+        }
+        g.src = { penX, penY, surfaces[i]->w, surfaces[i]->h };
+        penX += surfaces[i]->w + atlasPadding;
+        rowHeight = std::max(rowHeight, surfaces[i]->h);
+    }
+
+    atlas.font = font;
+    atlas.width = atlasWidth;
+    atlas.height = penY + rowHeight + atlasPadding;
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (sheet) {
+        SDL_FillRect(sheet, nullptr, 0);
+        for (int i = 0; i < glyphCount; i++) {
+            if (!surfaces[i]) continue;
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dst = atlas.glyphs[i].src;
+            SDL_BlitSurface(surfaces[i], nullptr, sheet, &dst);
+        }
+        atlas.texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        SDL_FreeSurface(sheet);
+    }
+    for (int i = 0; i < glyphCount; i++) {
+        if (surfaces[i]) SDL_FreeSurface(surfaces[i]);
+    }
+
+    if (!atlas.texture) {
+        std::cerr << "Error building glyph atlas: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void DestroyGlyphAtlas(GlyphAtlas& atlas) {
+    SDL_DestroyTexture(atlas.texture);
+    atlas.texture = nullptr;
+}
+
+static const Glyph* FindGlyph(const GlyphAtlas& atlas, char ch) {
+    int i = (unsigned char)ch - firstGlyph;
+    if (i < 0 || i >= glyphCount) i = '?' - firstGlyph;
+    return &atlas.glyphs[i];
+}
+
+static int Kerning(const GlyphAtlas& atlas, char prev, char ch) {
+    if (!prev || !atlas.font) return 0;
+    return TTF_GetFontKerningSizeGlyphs(atlas.font, (unsigned char)prev, (unsigned char)ch);
+}
+
+int MeasureText(const GlyphAtlas& atlas, const char* text) {
+    int w = 0;
+    char prev = 0;
+    for (const char* c = text; *c; c++) {
+        w += Kerning(atlas, prev, *c) + FindGlyph(atlas, *c)->advance;
+        prev = *c;
+    }
+    return w;
+}
+
+int TextHeight(const GlyphAtlas& atlas) {
+    return atlas.font ? TTF_FontHeight(atlas.font) : 0;
+}
+
+static void LayoutText(std::vector<SDL_Vertex>& out, const GlyphAtlas& atlas, const char* text, int x, int y, SDL_Color color) {
+    float invW = 1.0f / atlas.width;
+    float invH = 1.0f / atlas.height;
+    int penX = x;
+    char prev = 0;
+    for (const char* c = text; *c; c++) {
+        const Glyph* g = FindGlyph(atlas, *c);
+        penX += Kerning(atlas, prev, *c);
+        prev = *c;
+        if (g->src.w > 0) {
+            float x0 = (float)penX, y0 = (float)y;
+            float x1 = x0 + g->src.w, y1 = y0 + g->src.h;
+            float u0 = g->src.x * invW, v0 = g->src.y * invH;
+            float u1 = (g->src.x + g->src.w) * invW, v1 = (g->src.y + g->src.h) * invH;
+            out.push_back({ { x0, y0 }, color, { u0, v0 } });
+            out.push_back({ { x1, y0 }, color, { u1, v0 } });
+            out.push_back({ { x0, y1 }, color, { u0, v1 } });
+            out.push_back({ { x1, y1 }, color, { u1, v1 } });
+        }
+        penX += g->advance;
+    }
+}
+
+static void AppendQuads(QuadBatch& batch, const std::vector<SDL_Vertex>& vertices) {
+    size_t start = batch.vertices.size();
+    batch.vertices.insert(batch.vertices.end(), vertices.begin(), vertices.end());
+    EmitQuadIndices(batch, start);
+}
+
+void DrawText(QuadBatch& batch, const GlyphAtlas& atlas, const char* text, int x, int y, SDL_Color color) {
+    size_t start = batch.vertices.size();
+    LayoutText(batch.vertices, atlas, text, x, y, color);
+    EmitQuadIndices(batch, start);
+}
+
+static bool SameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void DrawLabel(QuadBatch& batch, const GlyphAtlas& atlas, TextLabel& label, const char* text, int x, int y, SDL_Color color) {
+    if (!label.built || label.hasValue || label.text != text || label.x != x || label.y != y || !SameColor(label.color, color)) {
+        label.vertices.clear();
+        LayoutText(label.vertices, atlas, text, x, y, color);
+        label.text = text;
+        label.hasValue = false;
+        label.x = x;
+        label.y = y;
+        label.color = color;
+        label.built = true;
+    }
+    AppendQuads(batch, label.vertices);
+}
+
+void DrawLabel(QuadBatch& batch, const GlyphAtlas& atlas, TextLabel& label, const char* prefix, int value, int x, int y, SDL_Color color) {
+    if (!label.built || !label.hasValue || label.value != value || label.text != prefix ||
+        label.x != x || label.y != y || !SameColor(label.color, color)) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%s%d", prefix, value);
+        label.vertices.clear();
+        LayoutText(label.vertices, atlas, buf, x, y, color);
+        label.text = prefix;
+        label.value = value;
+        label.hasValue = true;
+        label.x = x;
+        label.y = y;
+        label.color = color;
+        label.built = true;
+    }
+    AppendQuads(batch, label.vertices);
+}
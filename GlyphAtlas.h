@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include "RenderBatch.h"
+
+// Printable ASCII range baked into the atlas
+const int firstGlyph = 32;
+const int lastGlyph = 126;
+
+struct Glyph {
+    SDL_Rect src;   // pixels in the atlas texture
+    int advance;
+};
+
+struct GlyphAtlas {
+    SDL_Texture* texture = nullptr;
+    TTF_Font* font = nullptr;
+    int width = 0;
+    int height = 0;
+    Glyph glyphs[lastGlyph - firstGlyph + 1];
+};
+
+// Cached quads for one on-screen string; only rebuilt when its text, position or color changes
+struct TextLabel {
+    std::vector<SDL_Vertex> vertices;
+    std::string text;               // a copy, so a reused buffer with new contents still rebuilds
+    int value = 0;
+    bool hasValue = false;
+    int x = 0, y = 0;
+    SDL_Color color = { 0, 0, 0, 0 };
+    bool built = false;
+};
+
+bool BuildGlyphAtlas(GlyphAtlas& atlas, TTF_Font* font, SDL_Renderer* renderer);
+void DestroyGlyphAtlas(GlyphAtlas& atlas);
+int MeasureText(const GlyphAtlas& atlas, const char* text);
+int TextHeight(const GlyphAtlas& atlas);
+
+// Every string of a frame goes into one QuadBatch, flushed once with atlas.texture
+void DrawText(QuadBatch& batch, const GlyphAtlas& atlas, const char* text, int x, int y, SDL_Color color);
+void DrawLabel(QuadBatch& batch, const GlyphAtlas& atlas, TextLabel& label, const char* text, int x, int y, SDL_Color color);
+void DrawLabel(QuadBatch& batch, const GlyphAtlas& atlas, TextLabel& label, const char* prefix, int value, int x, int y, SDL_Color color);
@@ -0,0 +1,144 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job {
+    ChunkFunc func;
+    void* context;
+    size_t chunk, begin, end;
+};
+
+// One participant's run of chunks: the owner pops from the back, thieves take from the front.
+// Storage only grows, so dealing out a tick's chunks does not allocate once warmed up.
+struct JobQueue {
+    std::mutex mutex;
+    std::vector<Job> jobs;
+    size_t head = 0, tail = 0;
+};
+
+static std::vector<std::thread> workers;
+static std::unique_ptr<JobQueue[]> queues;  // [0] belongs to the thread calling RunChunks
+static int queueCount = 0;
+static std::mutex wakeMutex;
+static std::condition_variable wakeWorkers;
+static std::condition_variable batchDone;
+static unsigned batchGeneration = 0;
+static bool stopping = false;
+static std::atomic<size_t> remaining(0);
+
+static bool PopOwn(JobQueue& q, Job& job) {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.head == q.tail) return false;
+    job = q.jobs[--q.tail];
+    return true;
+}
+
+static bool Steal(JobQueue& q, Job& job) {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.head == q.tail) return false;
+    job = q.jobs[q.head++];
+    return true;
+}
+
+static bool NextJob(int self, Job& job) {
+    if (PopOwn(queues[self], job)) return true;
+    for (int i = 1; i < queueCount; i++) {
+        if (Steal(queues[(self + i) % queueCount], job)) return true;
+    }
+    return false;
+}
+
+static void RunJobs(int self) {
+    Job job;
+    while (NextJob(self, job)) {
+        job.func(job.context, job.chunk, job.begin, job.end);
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            batchDone.notify_one();
+        }
+    }
+}
+
+static void WorkerLoop(int self) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeWorkers.wait(lock, [&] { return stopping || batchGeneration != seen; });
+            if (stopping) return;
+            seen = batchGeneration;
+        }
+        RunJobs(self);
+    }
+}
+
+void StartJobSystem(int workerCount) {
+    // Workers must be joined before the statics above are destroyed, whichever way main exits
+    static bool registered = false;
+    if (!registered) {
+        atexit(StopJobSystem);
+        registered = true;
+    }
+    StopJobSystem();
+    workerCount = std::max(0, workerCount);
+    queueCount = workerCount + 1;
+    queues.reset(new JobQueue[queueCount]);
+    stopping = false;
+    for (int i = 1; i <= workerCount; i++) workers.emplace_back(WorkerLoop, i);
+}
+
+void StopJobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+    queues.reset();
+    queueCount = 0;
+}
+
+int JobWorkerCount() {
+    return (int)workers.size();
+}
+
+void RunChunks(size_t count, size_t chunkSize, ChunkFunc func, void* context) {
+    size_t chunks = ChunkCount(count, chunkSize);
+    if (chunks == 0) return;
+    if (workers.empty() || chunks == 1) {
+        for (size_t c = 0; c < chunks; c++) func(context, c, c * chunkSize, std::min(count, (c + 1) * chunkSize));
+        return;
+    }
+
+    // Contiguous runs keep each participant on neighbouring memory until it has to steal
+    size_t perQueue = (chunks + queueCount - 1) / queueCount;
+    remaining.store(chunks, std::memory_order_relaxed);
+    for (int q = 0; q < queueCount; q++) {
+        JobQueue& queue = queues[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        size_t first = std::min(chunks, q * perQueue), last = std::min(chunks, first + perQueue);
+        if (queue.jobs.size() < last - first) queue.jobs.resize(last - first);
+        queue.head = 0;
+        queue.tail = 0;
+        // Pushed last-to-first so the owner's back-pops walk its run in ascending order
+        for (size_t c = last; c-- > first;) {
+            queue.jobs[queue.tail++] = { func, context, c, c * chunkSize, std::min(count, (c + 1) * chunkSize) };
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        batchGeneration++;
+    }
+    wakeWorkers.notify_all();
+
+    RunJobs(0);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    batchDone.wait(lock, [] { return remaining.load(std::memory_order_acquire) == 0; });
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// Work-stealing pool for per-tick data-parallel loops. RunChunks cuts [0, count) into
+// fixed-size chunks and deals them out in contiguous runs, one run per participant (the
+// workers plus the calling thread). Each participant drains its own run from the back and
+// steals from the front of the others' runs when it runs dry. It returns once every chunk
+// has finished.
+//
+// Which thread runs a chunk is not deterministic, so a chunk must only write to its own
+// entity range and to per-chunk outputs, which the caller then merges in chunk order.
+typedef void (*ChunkFunc)(void* context, size_t chunk, size_t begin, size_t end);
+
+// workerCount 0 (or never starting the pool) runs every chunk inline on the caller.
+// The pool is stopped automatically at exit.
+void StartJobSystem(int workerCount);
+void StopJobSystem();
+int JobWorkerCount();
+
+inline size_t ChunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+void RunChunks(size_t count, size_t chunkSize, ChunkFunc func, void* context);
+
+// Same as RunChunks for a lambda or functor taking (chunk, begin, end)
+template <typename F>
+void ParallelFor(size_t count, size_t chunkSize, F& func) {
+    RunChunks(count, chunkSize, [](void* context, size_t chunk, size_t begin, size_t end) {
+        (*(F*)context)(chunk, begin, end);
+    }, &func);
+}
@@ -0,0 +1,165 @@
+#include "Leaderboard.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+bool LoadLeaderboard(Leaderboard& board, const char* path) {
+    board.count = 0;
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        ScoreEntry entry;
+        long long timestamp = 0;
+        // A bare number is the old single high score
+        if (sscanf(line, "%d %d %d %lld", &entry.score, &entry.wave, &entry.seconds, &timestamp) < 1) continue;
+        entry.timestamp = timestamp;
+        InsertScore(board, entry);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool ReplaceFile(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+bool SaveLeaderboard(const Leaderboard& board, const char* path) {
+    std::string tempPath = std::string(path) + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "w");
+    if (!file) return false;
+    bool ok = true;
+    for (int i = 0; i < board.count; i++) {
+        const ScoreEntry& e = board.entries[i];
+        ok = ok && fprintf(file, "%d %d %d %lld\n", e.score, e.wave, e.seconds, (long long)e.timestamp) > 0;
+    }
+    // The data has to be on disk before the rename makes it the real file
+    ok = ok && fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = fclose(file) == 0 && ok;
+    if (!ok || !ReplaceFile(tempPath.c_str(), path)) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void InsertScore(Leaderboard& board, const ScoreEntry& entry) {
+    int at = board.count;
+    while (at > 0 && board.entries[at - 1].score < entry.score) at--;
+    if (at == leaderboardSize) return;
+    int last = board.count < leaderboardSize ? board.count : leaderboardSize - 1;
+    for (int i = last; i > at; i--) board.entries[i] = board.entries[i - 1];
+    board.entries[at] = entry;
+    if (board.count < leaderboardSize) board.count++;
+}
+
+// Everything below is guarded by writerMutex
+static std::mutex writerMutex;
+static std::condition_variable writerWake;
+static std::thread writerThread;
+static std::string boardPath;
+static Leaderboard committed;
+static ScoreEntry currentRun;
+static bool writerRunning = false;
+static bool hasCurrentRun = false;
+static bool dirty = false;
+static bool flushNow = false;
+static bool stopWriter = false;
+static Uint32 flushInterval = 0;
+
+static void WriterLoop() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    for (;;) {
+        writerWake.wait_for(lock, std::chrono::milliseconds(flushInterval), [] { return flushNow || stopWriter; });
+        flushNow = false;
+        if (dirty) {
+            Leaderboard board = committed;
+            if (hasCurrentRun) {
+                ScoreEntry run = currentRun;
+                run.timestamp = (Sint64)time(nullptr);
+                InsertScore(board, run);
+            }
+            dirty = false;
+            // Write without the lock so posting a score never waits on the disk
+            lock.unlock();
+            bool saved = SaveLeaderboard(board, boardPath.c_str());
+            lock.lock();
+            if (!saved) {
+                fprintf(stderr, "Could not write %s\n", boardPath.c_str());
+            }
+        }
+        if (stopWriter && !dirty) break;
+    }
+}
+
+void StartScoreWriter(const char* path, const Leaderboard& board, Uint32 flushIntervalMs) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (writerRunning) return;
+    writerRunning = true;
+    boardPath = path;
+    committed = board;
+    hasCurrentRun = false;
+    dirty = false;
+    flushNow = false;
+    stopWriter = false;
+    flushInterval = flushIntervalMs;
+    writerThread = std::thread(WriterLoop);
+}
+
+void PostCurrentRun(const ScoreEntry& run) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (!writerRunning) return;
+    currentRun = run;
+    hasCurrentRun = true;
+    dirty = true;
+}
+
+static void CommitLocked() {
+    if (!hasCurrentRun) return;
+    currentRun.timestamp = (Sint64)time(nullptr);
+    InsertScore(committed, currentRun);
+    hasCurrentRun = false;
+    dirty = true;
+    flushNow = true;
+}
+
+void CommitCurrentRun() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!writerRunning) return;
+        CommitLocked();
+    }
+    writerWake.notify_one();
+}
+
+void StopScoreWriter() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!writerRunning) return;
+        writerRunning = false;
+        CommitLocked();
+        stopWriter = true;
+    }
+    writerWake.notify_one();
+    writerThread.join();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL.h>
+
+// score.txt: one finished run per line, best first: "score wave seconds timestamp", where
+// timestamp is Unix seconds. A file holding just one number (the old high-score format)
+// loads as a single entry with no metadata.
+const int leaderboardSize = 10;
+
+struct ScoreEntry {
+    int score = 0;
+    int wave = 0;
+    int seconds = 0;        // game time survived
+    Sint64 timestamp = 0;
+};
+
+struct Leaderboard {
+    ScoreEntry entries[leaderboardSize];
+    int count = 0;
+};
+
+bool LoadLeaderboard(Leaderboard& board, const char* path);
+// Writes to path.tmp, then renames over path, so a crash leaves either the old or the new file
+bool SaveLeaderboard(const Leaderboard& board, const char* path);
+// Keeps the table sorted by score, earlier runs first on ties; drops whatever falls off the end
+void InsertScore(Leaderboard& board, const ScoreEntry& entry);
+
+// Background writer, so the game never touches the disk itself. Updates are coalesced:
+// only the newest state is written, at most once per flushIntervalMs, or at once on commit.
+void StartScoreWriter(const char* path, const Leaderboard& board, Uint32 flushIntervalMs);
+// The run in progress; written with the table on the next timed flush, so a crash mid-game
+// keeps the score it had reached. Cheap enough to call on every score change.
+void PostCurrentRun(const ScoreEntry& run);
+// The run is over: stamps it, folds it into the table and flushes right away
+void CommitCurrentRun();
+// Commits the current run, writes anything pending and joins the writer
+void StopScoreWriter();
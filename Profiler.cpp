@@ -0,0 +1,122 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent {
+    ProfileStage stage;
+    int thread;
+    Uint64 start, end;
+};
+
+static const char* stageNames[STAGE_COUNT] = {
+    "Events", "Simulation", "UpdateEnemies", "UpdateProjectiles", "RenderHUD",
+    "DrawEntities", "DrawText", "Present", "Sleep", "Frame"
+};
+
+static Uint64 frameTotals[STAGE_COUNT];
+static float history[STAGE_COUNT][profileWindow];
+static int historyCount = 0;
+static int historyNext = 0;
+static Uint64 frameIndex = 0;
+static Uint64 origin = 0;
+static double msPerCount = 0.0;
+static FILE* csvFile = nullptr;
+static FILE* traceFile = nullptr;
+static bool firstTraceEvent = true;
+static std::vector<TraceEvent> traceEvents;
+// The sim thread adds samples while the render thread opens and closes frames
+static std::mutex sampleMutex;
+static std::atomic<int> nextTraceThread(1);
+static thread_local int traceThread = 0;
+
+bool InitProfiler(const char* csvPath, const char* tracePath) {
+    origin = SDL_GetPerformanceCounter();
+    msPerCount = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (csvPath) {
+        csvFile = fopen(csvPath, "w");
+        if (!csvFile) {
+            std::cerr << "Error opening profile CSV: " << csvPath << std::endl;
+            return false;
+        }
+        fprintf(csvFile, "frame");
+        for (int s = 0; s < STAGE_COUNT; s++) fprintf(csvFile, ",%s_ms", stageNames[s]);
+        fprintf(csvFile, "\n");
+    }
+    if (tracePath) {
+        traceFile = fopen(tracePath, "w");
+        if (!traceFile) {
+            std::cerr << "Error opening profile trace: " << tracePath << std::endl;
+            return false;
+        }
+        fprintf(traceFile, "{\"traceEvents\":[\n");
+        traceEvents.reserve(256);
+    }
+    return true;
+}
+
+void ShutdownProfiler() {
+    if (csvFile) fclose(csvFile);
+    if (traceFile) {
+        fprintf(traceFile, "\n]}\n");
+        fclose(traceFile);
+    }
+    csvFile = traceFile = nullptr;
+}
+
+void BeginProfileFrame() {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    std::fill(frameTotals, frameTotals + STAGE_COUNT, 0);
+}
+
+void AddProfileSample(ProfileStage stage, Uint64 start, Uint64 end) {
+    if (!traceThread) traceThread = nextTraceThread++;
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    frameTotals[stage] += end - start;
+    if (traceFile) traceEvents.push_back({ stage, traceThread, start, end });
+}
+
+void EndProfileFrame() {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    for (int s = 0; s < STAGE_COUNT; s++) history[s][historyNext] = (float)(frameTotals[s] * msPerCount);
+    historyNext = (historyNext + 1) % profileWindow;
+    if (historyCount < profileWindow) historyCount++;
+
+    if (csvFile) {
+        fprintf(csvFile, "%llu", (unsigned long long)frameIndex);
+        for (int s = 0; s < STAGE_COUNT; s++) fprintf(csvFile, ",%.4f", frameTotals[s] * msPerCount);
+        fprintf(csvFile, "\n");
+    }
+    if (traceFile) {
+        // Complete ("X") events, timestamps in microseconds since InitProfiler
+        for (const TraceEvent& e : traceEvents) {
+            fprintf(traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    firstTraceEvent ? "" : ",\n", stageNames[e.stage], e.thread,
+                    (e.start - origin) * msPerCount * 1000.0, (e.end - e.start) * msPerCount * 1000.0);
+            firstTraceEvent = false;
+        }
+        traceEvents.clear();
+    }
+    frameIndex++;
+}
+
+StageStats GetStageStats(ProfileStage stage) {
+    StageStats stats = { 0.0f, 0.0f, 0.0f };
+    if (historyCount == 0) return stats;
+    float sorted[profileWindow];
+    std::copy(history[stage], history[stage] + historyCount, sorted);
+    std::sort(sorted, sorted + historyCount);
+    float sum = 0.0f;
+    for (int i = 0; i < historyCount; i++) sum += sorted[i];
+    stats.minMs = sorted[0];
+    stats.avgMs = sum / historyCount;
+    stats.p99Ms = sorted[std::min(historyCount - 1, (historyCount * 99) / 100)];
+    return stats;
+}
+
+const char* ProfileStageName(ProfileStage stage) {
+    return stageNames[stage];
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL.h>
+
+enum ProfileStage {
+    STAGE_EVENTS,
+    STAGE_SIMULATION,
+    STAGE_UPDATE_ENEMIES,
+    STAGE_UPDATE_PROJECTILES,
+    STAGE_RENDER_HUD,
+    STAGE_DRAW_ENTITIES,
+    STAGE_DRAW_TEXT,
+    STAGE_PRESENT,
+    STAGE_SLEEP,
+    STAGE_FRAME,     // everything but the sleep
+    STAGE_COUNT
+};
+
+// Frames kept for the rolling min/avg/p99
+const int profileWindow = 240;
+
+struct StageStats {
+    float minMs, avgMs, p99Ms;
+};
+
+// Either path may be null. CSV gets one row per frame with the time of every stage;
+// the trace is Chrome trace-event JSON (chrome://tracing, Perfetto) with one event per scope.
+bool InitProfiler(const char* csvPath, const char* tracePath);
+void ShutdownProfiler();
+void BeginProfileFrame();
+void EndProfileFrame();
+// Safe from any thread; samples count toward whichever frame the render thread has open
+void AddProfileSample(ProfileStage stage, Uint64 start, Uint64 end);
+StageStats GetStageStats(ProfileStage stage);
+const char* ProfileStageName(ProfileStage stage);
+
+// Times the enclosing block; stages hit several times in a frame (e.g. once per tick) add up
+struct ProfileScope {
+    ProfileStage stage;
+    Uint64 start;
+    explicit ProfileScope(ProfileStage s) : stage(s), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { AddProfileSample(stage, start, SDL_GetPerformanceCounter()); }
+};
@@ -0,0 +1,30 @@
+#include "ProjectilePool.h"
+#include <cmath>
+
+void ReservePool(ProjectilePool& pool, size_t capacity) {
+    if (capacity <= pool.capacity) return;
+    ReserveEntities(pool.store, capacity);
+    pool.capacity = capacity;
+}
+
+bool SpawnProjectile(ProjectilePool& pool, float x, float y, float w, float h, float vx, float vy) {
+    size_t live = EntityCount(pool.store);
+    if (live >= pool.capacity) {
+        pool.exhausted++;
+        return false;
+    }
+    AddEntity(pool.store, x, y, w, h, vx, vy, 0);
+    if (live + 1 > pool.highWater) pool.highWater = live + 1;
+    return true;
+}
+
+void ResetPoolStats(ProjectilePool& pool) {
+    pool.highWater = EntityCount(pool.store);
+    pool.exhausted = 0;
+}
+
+size_t ProjectileCapacityForWave(int shooters, Uint32 shootIntervalMs, float bulletSpeed, int arenaW, int arenaH) {
+    float flightMs = sqrtf((float)(arenaW * arenaW + arenaH * arenaH)) / bulletSpeed * 1000.0f;
+    size_t perShooter = (size_t)ceilf(flightMs / (float)shootIntervalMs) + 1;
+    return (size_t)shooters * perShooter;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "EntityStore.h"
+
+// Fixed-capacity projectile storage. The EntityStore arrays and its slot free list are
+// reserved up front, so spawning and despawning never touch the heap; when the pool is
+// full a spawn is refused and counted instead of growing.
+struct ProjectilePool {
+    EntityStore store;
+    size_t capacity = 0;
+    size_t highWater = 0;   // most projectiles alive at once
+    Uint32 exhausted = 0;   // spawns refused because the pool was full
+};
+
+// Grows the pool to at least `capacity`; never shrinks. Only call outside the tick loop.
+void ReservePool(ProjectilePool& pool, size_t capacity);
+bool SpawnProjectile(ProjectilePool& pool, float x, float y, float w, float h, float vx, float vy);
+void ResetPoolStats(ProjectilePool& pool);
+// Upper bound on live projectiles for a wave: every shooter firing once per interval for the
+// longest possible flight across the arena
+size_t ProjectileCapacityForWave(int shooters, Uint32 shootIntervalMs, float bulletSpeed, int arenaW, int arenaH);
@@ -0,0 +1,31 @@
+#include "RenderBatch.h"
+
+void EmitQuadIndices(QuadBatch& batch, size_t firstVertex) {
+    for (size_t v = firstVertex; v + 3 < batch.vertices.size(); v += 4) {
+        int i = (int)v;
+        int quad[6] = { i, i + 1, i + 2, i + 2, i + 1, i + 3 };
+        batch.indices.insert(batch.indices.end(), quad, quad + 6);
+    }
+}
+
+void AddQuad(QuadBatch& batch, float x, float y, float w, float h, SDL_Color color) {
+    AddQuad(batch, x, y, w, h, color, { 0.0f, 0.0f, 0.0f, 0.0f });
+}
+
+void AddQuad(QuadBatch& batch, float x, float y, float w, float h, SDL_Color color, const SDL_FRect& uv) {
+    size_t start = batch.vertices.size();
+    batch.vertices.push_back({ { x, y }, color, { uv.x, uv.y } });
+    batch.vertices.push_back({ { x + w, y }, color, { uv.x + uv.w, uv.y } });
+    batch.vertices.push_back({ { x, y + h }, color, { uv.x, uv.y + uv.h } });
+    batch.vertices.push_back({ { x + w, y + h }, color, { uv.x + uv.w, uv.y + uv.h } });
+    EmitQuadIndices(batch, start);
+}
+
+void FlushQuads(QuadBatch& batch, SDL_Texture* texture, SDL_Renderer* renderer) {
+    if (!batch.indices.empty()) {
+        SDL_RenderGeometry(renderer, texture, batch.vertices.data(), (int)batch.vertices.size(),
+                           batch.indices.data(), (int)batch.indices.size());
+    }
+    batch.vertices.clear();
+    batch.indices.clear();
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Quads collected over a frame and submitted with one SDL_RenderGeometry call.
+// Buffers are cleared but keep their capacity, so steady-state frames do not allocate.
+struct QuadBatch {
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+
+// Adds the index pairs for every quad appended to batch.vertices since `firstVertex`
+void EmitQuadIndices(QuadBatch& batch, size_t firstVertex);
+// Solid quad; color is stored per vertex so quads of any color share the batch
+void AddQuad(QuadBatch& batch, float x, float y, float w, float h, SDL_Color color);
+// Textured quad; uv is in normalized texture coordinates
+void AddQuad(QuadBatch& batch, float x, float y, float w, float h, SDL_Color color, const SDL_FRect& uv);
+// Draws everything in the batch with `texture` (nullptr for solid quads) and empties it
+void FlushQuads(QuadBatch& batch, SDL_Texture* texture, SDL_Renderer* renderer);
@@ -0,0 +1,166 @@
+#include "Replay.h"
+#include "Game.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// File layout, little-endian:
+//   "CEAR" u8 version u8 simdLevel u64 seed varint wavesLength wavesText
+//   events: varint tickDelta, u8 kind, then varint key (REPLAY_KEY, REPLAY_MOVE_KEYS) or u16 x, u16 y (REPLAY_CLICK)
+//   0x00 end marker, varint endTick, u64 endHash
+static const char replayMagic[4] = { 'C', 'E', 'A', 'R' };
+// Version 2: movement follows held keys every tick instead of jumping on key presses
+// Version 3: every enemy fires on its own cooldown, and timers are part of the state hash
+// Version 4: carries the wave table, so a rerun does not depend on the waves.txt on disk
+static const Uint8 replayVersion = 4;
+static const Uint8 replayEnd = 0;
+
+static void PutVarint(std::vector<Uint8>& out, Uint64 v) {
+    while (v >= 0x80) {
+        out.push_back((Uint8)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((Uint8)v);
+}
+
+static void PutFixed(std::vector<Uint8>& out, Uint64 v, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((Uint8)(v >> (8 * i)));
+}
+
+static bool GetVarint(const std::vector<Uint8>& in, size_t& pos, Uint64& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        Uint8 b = in[pos++];
+        v |= (Uint64)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool GetFixed(const std::vector<Uint8>& in, size_t& pos, Uint64& v, int bytes) {
+    if (pos + bytes > in.size()) return false;
+    v = 0;
+    for (int i = 0; i < bytes; i++) v |= (Uint64)in[pos++] << (8 * i);
+    return true;
+}
+
+bool SaveReplay(const char* path, const Replay& replay) {
+    std::vector<Uint8> out(replayMagic, replayMagic + 4);
+    out.push_back(replayVersion);
+    out.push_back(replay.simdLevel);
+    PutFixed(out, replay.seed, 8);
+    PutVarint(out, replay.waves.size());
+    out.insert(out.end(), replay.waves.begin(), replay.waves.end());
+    Uint64 lastTick = 0;
+    for (const ReplayEvent& e : replay.events) {
+        PutVarint(out, e.tick - lastTick);
+        lastTick = e.tick;
+        out.push_back(e.kind);
+        if (e.kind == REPLAY_KEY || e.kind == REPLAY_MOVE_KEYS) {
+            PutVarint(out, (Uint32)e.key);
+        } else {
+            PutFixed(out, (Uint16)e.x, 2);
+            PutFixed(out, (Uint16)e.y, 2);
+        }
+    }
+    // The end marker sits where a tick delta would, so it carries a zero delta first
+    PutVarint(out, 0);
+    out.push_back(replayEnd);
+    PutVarint(out, replay.endTick);
+    PutFixed(out, replay.endHash, 8);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        std::cerr << "Error writing replay: " << path << std::endl;
+        return false;
+    }
+    fwrite(out.data(), 1, out.size(), file);
+    fclose(file);
+    return true;
+}
+
+bool LoadReplay(const char* path, Replay& replay) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        std::cerr << "Error opening replay: " << path << std::endl;
+        return false;
+    }
+    std::vector<Uint8> in;
+    Uint8 chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) in.insert(in.end(), chunk, chunk + n);
+    fclose(file);
+
+    size_t pos = 6;
+    Uint64 v;
+    if (in.size() < 14 || memcmp(in.data(), replayMagic, 4) != 0 || in[4] != replayVersion) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+    replay.simdLevel = in[5];
+    GetFixed(in, pos, replay.seed, 8);
+    Uint64 wavesLength;
+    if (!GetVarint(in, pos, wavesLength) || wavesLength > in.size() - pos) {
+        std::cerr << "Truncated replay: " << path << std::endl;
+        return false;
+    }
+    replay.waves.assign((const char*)in.data() + pos, (size_t)wavesLength);
+    pos += (size_t)wavesLength;
+    replay.events.clear();
+    Uint64 tick = 0;
+    for (;;) {
+        Uint64 delta;
+        if (!GetVarint(in, pos, delta) || pos >= in.size()) break;
+        tick += delta;
+        Uint8 kind = in[pos++];
+        if (kind == replayEnd) {
+            if (GetVarint(in, pos, replay.endTick) && GetFixed(in, pos, replay.endHash, 8)) return true;
+            break;
+        }
+        ReplayEvent e = { tick, kind, 0, 0, 0 };
+        if (kind == REPLAY_KEY || kind == REPLAY_MOVE_KEYS) {
+            if (!GetVarint(in, pos, v)) break;
+            e.key = (Sint32)(Uint32)v;
+        } else {
+            Uint64 x, y;
+            if (!GetFixed(in, pos, x, 2) || !GetFixed(in, pos, y, 2)) break;
+            e.x = (Sint16)x;
+            e.y = (Sint16)y;
+        }
+        replay.events.push_back(e);
+    }
+    std::cerr << "Truncated replay: " << path << std::endl;
+    return false;
+}
+
+ReplayEvent ToReplayEvent(const SDL_Event& event, Uint64 tick) {
+    ReplayEvent e = { tick, 0, 0, 0, 0 };
+    if (event.type == SDL_KEYDOWN) {
+        e.kind = REPLAY_KEY;
+        e.key = event.key.keysym.sym;
+    } else if (event.type == moveKeysEvent) {
+        e.kind = REPLAY_MOVE_KEYS;
+        e.key = event.user.code;
+    } else {
+        e.kind = REPLAY_CLICK;
+        e.x = (Sint16)event.button.x;
+        e.y = (Sint16)event.button.y;
+    }
+    return e;
+}
+
+SDL_Event ToSdlEvent(const ReplayEvent& e) {
+    if (e.kind == REPLAY_MOVE_KEYS) return MakeMoveKeysEvent((Uint8)e.key);
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    if (e.kind == REPLAY_KEY) {
+        event.type = SDL_KEYDOWN;
+        event.key.keysym.sym = e.key;
+    } else {
+        event.type = SDL_MOUSEBUTTONDOWN;
+        event.button.button = SDL_BUTTON_LEFT;
+        event.button.x = e.x;
+        event.button.y = e.y;
+    }
+    return event;
+}
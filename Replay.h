@@ -0,0 +1,37 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+enum ReplayEventKind : Uint8 {
+    REPLAY_KEY = 1,
+    REPLAY_CLICK = 2,
+    REPLAY_MOVE_KEYS = 3,   // key holds the new set of held MoveKeys
+};
+
+// One input that reached the simulation, stamped with the tick it was applied before
+struct ReplayEvent {
+    Uint64 tick;
+    Uint8 kind;
+    Sint32 key;
+    Sint16 x, y;
+};
+
+// Everything needed to rerun a session: the RNG seed, the SIMD level (it changes float
+// rounding), the wave table, every input in order, and a hash of the final state to check
+// the rerun against
+struct Replay {
+    Uint64 seed = 0;
+    Uint8 simdLevel = 0;
+    std::string waves;      // waves.txt text the session ran with; empty for the built-in table
+    std::vector<ReplayEvent> events;
+    Uint64 endTick = 0;
+    Uint64 endHash = 0;
+};
+
+bool SaveReplay(const char* path, const Replay& replay);
+bool LoadReplay(const char* path, Replay& replay);
+
+// Sim inputs (key down, left click) to and from their recorded form
+ReplayEvent ToReplayEvent(const SDL_Event& event, Uint64 tick);
+SDL_Event ToSdlEvent(const ReplayEvent& e);
@@ -0,0 +1,29 @@
+#pragma once
+#include <SDL.h>
+
+// PCG32 (pcg-random.org): small, fast and identical on every platform, unlike rand()
+struct Rng {
+    Uint64 state = 0x853c49e6748fea9bULL;
+    Uint64 inc = 0xda3e39cb94b95bdbULL;
+};
+
+inline Uint32 NextRandom(Rng& rng) {
+    Uint64 old = rng.state;
+    rng.state = old * 6364136223846793005ULL + rng.inc;
+    Uint32 xorshifted = (Uint32)(((old >> 18u) ^ old) >> 27u);
+    Uint32 rot = (Uint32)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+inline void SeedRng(Rng& rng, Uint64 seed, Uint64 stream = 54) {
+    rng.state = 0;
+    rng.inc = (stream << 1u) | 1u;
+    NextRandom(rng);
+    rng.state += seed;
+    NextRandom(rng);
+}
+
+// Uniform integer in [0, bound)
+inline int RandomInt(Rng& rng, int bound) {
+    return (int)(((Uint64)NextRandom(rng) * (Uint64)bound) >> 32);
+}
@@ -0,0 +1,38 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+// Heap order: true when a should pop after b
+static bool Later(const ScheduledEvent& a, const ScheduledEvent& b) {
+    if (a.due != b.due) return a.due > b.due;
+    return a.sequence > b.sequence;
+}
+
+void ScheduleEvent(Scheduler& scheduler, Uint32 due, Uint8 kind, EntityHandle target) {
+    ScheduledEvent event;
+    event.due = due;
+    event.sequence = scheduler.nextSequence++;
+    event.target = target;
+    event.kind = kind;
+    scheduler.heap.push_back(event);
+    std::push_heap(scheduler.heap.begin(), scheduler.heap.end(), Later);
+}
+
+bool PopDueEvent(Scheduler& scheduler, Uint32 now, ScheduledEvent& event) {
+    if (scheduler.heap.empty() || scheduler.heap.front().due > now) return false;
+    std::pop_heap(scheduler.heap.begin(), scheduler.heap.end(), Later);
+    event = scheduler.heap.back();
+    scheduler.heap.pop_back();
+    return true;
+}
+
+void CancelEvents(Scheduler& scheduler, Uint8 kind) {
+    std::vector<ScheduledEvent>& heap = scheduler.heap;
+    heap.erase(std::remove_if(heap.begin(), heap.end(), [kind](const ScheduledEvent& e) { return e.kind == kind; }),
+               heap.end());
+    std::make_heap(heap.begin(), heap.end(), Later);
+}
+
+void ClearEvents(Scheduler& scheduler) {
+    scheduler.heap.clear();
+    scheduler.nextSequence = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "EntityStore.h"
+
+// Timed events on the simulation clock, kept in a binary min-heap. Every timer is one
+// pending event, so a tick pops only what is due instead of polling every entity: thousands
+// of shooters on their own cooldowns cost O(log n) per shot and nothing in between.
+enum ScheduledKind : Uint8 { EVENT_ENEMY_FIRE, EVENT_WAVE_END, EVENT_INVULNERABLE_END };
+
+struct ScheduledEvent {
+    Uint32 due;             // SimTimeMs()
+    Uint32 sequence;        // scheduling order; breaks ties so equal times always pop the same way
+    EntityHandle target;    // the enemy, for EVENT_ENEMY_FIRE; stale once it is removed
+    Uint8 kind;
+};
+
+struct Scheduler {
+    std::vector<ScheduledEvent> heap;
+    Uint32 nextSequence = 0;
+};
+
+void ScheduleEvent(Scheduler& scheduler, Uint32 due, Uint8 kind, EntityHandle target = EntityHandle());
+// Pops the earliest event due at or before `now`; false once nothing more is due
+bool PopDueEvent(Scheduler& scheduler, Uint32 now, ScheduledEvent& event);
+// Drops every pending event of one kind, O(n)
+void CancelEvents(Scheduler& scheduler, Uint8 kind);
+// Keeps the heap's capacity, so rescheduling after a clear does not allocate
+void ClearEvents(Scheduler& scheduler);
+inline size_t PendingEvents(const Scheduler& scheduler) { return scheduler.heap.size(); }
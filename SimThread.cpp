@@ -0,0 +1,125 @@
+#include "SimThread.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Single-producer/single-consumer ring: the render thread writes inputTail, the sim thread inputHead
+const Uint32 inputCapacity = 256;
+static ReplayEvent inputs[inputCapacity];
+static std::atomic<Uint32> inputHead(0);
+static std::atomic<Uint32> inputTail(0);
+
+static SnapshotBuffer snapshots;
+static std::thread simThread;
+static std::atomic<bool> stopRequested(false);
+static Replay* simRecording = nullptr;
+
+// Outside PLAYING the sim thread waits here for an input or a stop. The pusher only takes
+// the mutex while the sim is parked, so the ring stays lock-free during play.
+static std::mutex parkMutex;
+static std::condition_variable parkWake;
+static std::atomic<bool> simParked(false);
+
+static void WakeSim() {
+    // Pairs with the fence in ParkSim: either the sim sees the new input or we see it parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!simParked.load(std::memory_order_relaxed)) return;
+    { std::lock_guard<std::mutex> lock(parkMutex); }
+    parkWake.notify_one();
+}
+
+bool PushSimInput(const SDL_Event& event) {
+    Uint32 tail = inputTail.load(std::memory_order_relaxed);
+    if (tail - inputHead.load(std::memory_order_acquire) == inputCapacity) return false;
+    inputs[tail % inputCapacity] = ToReplayEvent(event, 0);
+    inputTail.store(tail + 1, std::memory_order_release);
+    WakeSim();
+    return true;
+}
+
+Uint32 SimInputsQueued() {
+    return inputTail.load(std::memory_order_relaxed);
+}
+
+static bool SimHasWork() {
+    return stopRequested.load(std::memory_order_acquire) ||
+           inputTail.load(std::memory_order_acquire) != inputHead.load(std::memory_order_relaxed);
+}
+
+static void ParkSim() {
+    std::unique_lock<std::mutex> lock(parkMutex);
+    simParked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    parkWake.wait(lock, SimHasWork);
+    simParked.store(false, std::memory_order_relaxed);
+}
+
+static void ApplyQueuedInputs() {
+    Uint32 head = inputHead.load(std::memory_order_relaxed);
+    Uint32 tail = inputTail.load(std::memory_order_acquire);
+    for (; head != tail; head++) {
+        ReplayEvent e = inputs[head % inputCapacity];
+        e.tick = simClock.tick;
+        if (simRecording) simRecording->events.push_back(e);
+        HandleSimEvent(ToSdlEvent(e));
+    }
+    inputHead.store(head, std::memory_order_release);
+}
+
+static void Publish() {
+    GameSnapshot& slot = SnapshotWriteSlot(snapshots);
+    CaptureSnapshot(slot);
+    slot.publishedAt = SDL_GetPerformanceCounter();
+    slot.inputsApplied = inputHead.load(std::memory_order_relaxed);
+    PublishSnapshot(snapshots);
+}
+
+static void SimLoop() {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 tickCounts = frequency / simTickRate;
+    Uint64 next = SDL_GetPerformanceCounter();
+    Uint64 loops = 0;
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now < next) {
+            // Rounded up: a truncated SDL_Delay(0) would spin through the last millisecond
+            SDL_Delay((Uint32)(((next - now) * 1000 + frequency - 1) / frequency));
+            continue;
+        }
+        if (now - next > frequency / 4) next = now; // avoid a spiral of death after a long stall
+        // A recording holds the table it started with, so it must not change underneath it
+        if (!simRecording && ++loops % simTickRate == 0) PollWaveFile();
+        ApplyQueuedInputs();
+        // The clock only runs while playing, so pauses freeze game time as before
+        if (gameState == PLAYING) {
+            ProfileScope scope(STAGE_SIMULATION);
+            StepSimulation();
+        }
+        Publish();
+        next += tickCounts;
+        // Nothing advances outside PLAYING and the last state is published: sleep until an input
+        if (gameState != PLAYING && !SimHasWork()) {
+            ParkSim();
+            next = SDL_GetPerformanceCounter();
+        }
+    }
+}
+
+void StartSimThread(Replay* recording) {
+    simRecording = recording;
+    Publish();
+    stopRequested = false;
+    simThread = std::thread(SimLoop);
+}
+
+void StopSimThread() {
+    if (!simThread.joinable()) return;
+    stopRequested = true;
+    WakeSim();
+    simThread.join();
+}
+
+const GameSnapshot& LatestSnapshot() {
+    return ReadSnapshot(snapshots);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <SDL.h>
+#include "GameSnapshot.h"
+#include "Replay.h"
+
+// Runs the fixed-step simulation on its own thread, so a slow present or a driver stall on
+// the render thread never delays a tick. Outside PLAYING nothing advances, so the thread
+// parks until an input arrives instead of waking every tick. While it runs, the sim thread owns every game
+// global: the render thread only queues inputs and reads published snapshots.
+
+// Publishes a snapshot of the current state, then starts ticking. Inputs are recorded
+// into `recording` (stamped with the tick they were applied before) if it is not null.
+void StartSimThread(Replay* recording);
+void StopSimThread();
+
+// Render thread: hands a key press or click to the sim, applied before its next tick.
+// Returns false if the queue is full and the input was dropped.
+bool PushSimInput(const SDL_Event& event);
+// Inputs pushed so far; once a snapshot's inputsApplied matches, it shows their effect
+Uint32 SimInputsQueued();
+const GameSnapshot& LatestSnapshot();
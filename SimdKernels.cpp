@@ -0,0 +1,211 @@
+#include "SimdKernels.h"
+#include <cmath>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SIMD_TARGET(isa)
+#else
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// Below this squared length the push has all but cancelled the pull, and the heading is noise
+const float minHeading2 = 1e-6f;
+
+static void ChaseScalar(float* x, float* y, const float* w, const float* h, const Uint8* type, size_t begin, size_t n,
+                        const float* stepByType, const float* aimX, const float* aimY, const float* pushX, const float* pushY) {
+    for (size_t i = begin; i < n; i++) {
+        float step = stepByType[type[i]];
+        if (step <= 0.0f) continue;
+        float dx = aimX[i] - (x[i] + w[i] * 0.5f);
+        float dy = aimY[i] - (y[i] + h[i] * 0.5f);
+        float len2 = dx * dx + dy * dy;
+        if (len2 > 0) {
+            float r = 1.0f / sqrtf(len2);
+            dx *= r;
+            dy *= r;
+        }
+        dx += pushX[i];
+        dy += pushY[i];
+        float heading2 = dx * dx + dy * dy;
+        if (heading2 > minHeading2) {
+            float s = step / sqrtf(heading2);
+            x[i] += dx * s;
+            y[i] += dy * s;
+        }
+    }
+}
+
+static void IntegrateScalar(float* x, float* y, const float* vx, const float* vy, size_t begin, size_t n, float dt) {
+    for (size_t i = begin; i < n; i++) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+#if SIMD_X86
+static bool CpuHasFma() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 12)) != 0;
+#else
+    return __builtin_cpu_supports("fma");
+#endif
+}
+
+// rsqrt estimate refined with one Newton-Raphson step: r * (1.5 - 0.5 * v * r * r)
+SIMD_TARGET("sse2")
+static __m128 RsqrtSse2(__m128 v) {
+    const __m128 half = _mm_set1_ps(0.5f), threeHalves = _mm_set1_ps(1.5f);
+    __m128 r = _mm_rsqrt_ps(v);
+    return _mm_mul_ps(r, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, v), _mm_mul_ps(r, r))));
+}
+
+SIMD_TARGET("sse2")
+static void ChaseSse2(float* x, float* y, const float* w, const float* h, const Uint8* type, size_t n,
+                      const float* stepByType, const float* aimX, const float* aimY, const float* pushX, const float* pushY) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps(), minH2 = _mm_set1_ps(minHeading2);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(aimX + i), _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(w + i), half)));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(aimY + i), _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(h + i), half)));
+        __m128 len2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        // rsqrt(0) is inf; an entity on its aim point has no pull, only the push
+        __m128 r = _mm_and_ps(RsqrtSse2(len2), _mm_cmpgt_ps(len2, zero));
+        __m128 hx = _mm_add_ps(_mm_mul_ps(dx, r), _mm_loadu_ps(pushX + i));
+        __m128 hy = _mm_add_ps(_mm_mul_ps(dy, r), _mm_loadu_ps(pushY + i));
+        __m128 heading2 = _mm_add_ps(_mm_mul_ps(hx, hx), _mm_mul_ps(hy, hy));
+        // SSE2 has no gather; four scalar loads from the per-type table
+        __m128 stepv = _mm_setr_ps(stepByType[type[i]], stepByType[type[i + 1]], stepByType[type[i + 2]], stepByType[type[i + 3]]);
+        // Leave zero-step types and cancelled headings where they are
+        __m128 keep = _mm_and_ps(_mm_cmpgt_ps(stepv, zero), _mm_cmpgt_ps(heading2, minH2));
+        __m128 s = _mm_and_ps(_mm_mul_ps(RsqrtSse2(heading2), stepv), keep);
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(hx, s)));
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(hy, s)));
+    }
+    ChaseScalar(x, y, w, h, type, i, n, stepByType, aimX, aimY, pushX, pushY);
+}
+
+SIMD_TARGET("sse2")
+static void IntegrateSse2(float* x, float* y, const float* vx, const float* vy, size_t n, float dt) {
+    const __m128 dtv = _mm_set1_ps(dt);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dtv)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dtv)));
+    }
+    IntegrateScalar(x, y, vx, vy, i, n, dt);
+}
+
+SIMD_TARGET("avx2,fma")
+static __m256 RsqrtAvx2(__m256 v) {
+    const __m256 half = _mm256_set1_ps(0.5f), threeHalves = _mm256_set1_ps(1.5f);
+    __m256 r = _mm256_rsqrt_ps(v);
+    return _mm256_mul_ps(r, _mm256_fnmadd_ps(_mm256_mul_ps(half, v), _mm256_mul_ps(r, r), threeHalves));
+}
+
+SIMD_TARGET("avx2,fma")
+static void ChaseAvx2(float* x, float* y, const float* w, const float* h, const Uint8* type, size_t n,
+                      const float* stepByType, const float* aimX, const float* aimY, const float* pushX, const float* pushY) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 zero = _mm256_setzero_ps(), minH2 = _mm256_set1_ps(minHeading2);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(aimX + i), _mm256_fmadd_ps(_mm256_loadu_ps(w + i), half, px));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(aimY + i), _mm256_fmadd_ps(_mm256_loadu_ps(h + i), half, py));
+        __m256 len2 = _mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy));
+        __m256 r = _mm256_and_ps(RsqrtAvx2(len2), _mm256_cmp_ps(len2, zero, _CMP_GT_OQ));
+        __m256 hx = _mm256_fmadd_ps(dx, r, _mm256_loadu_ps(pushX + i));
+        __m256 hy = _mm256_fmadd_ps(dy, r, _mm256_loadu_ps(pushY + i));
+        __m256 heading2 = _mm256_fmadd_ps(hx, hx, _mm256_mul_ps(hy, hy));
+        __m256i t = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(type + i)));
+        __m256 stepv = _mm256_i32gather_ps(stepByType, t, 4);
+        __m256 keep = _mm256_and_ps(_mm256_cmp_ps(stepv, zero, _CMP_GT_OQ), _mm256_cmp_ps(heading2, minH2, _CMP_GT_OQ));
+        __m256 s = _mm256_and_ps(_mm256_mul_ps(RsqrtAvx2(heading2), stepv), keep);
+        _mm256_storeu_ps(x + i, _mm256_fmadd_ps(hx, s, px));
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(hy, s, py));
+    }
+    ChaseScalar(x, y, w, h, type, i, n, stepByType, aimX, aimY, pushX, pushY);
+}
+
+SIMD_TARGET("avx2,fma")
+static void IntegrateAvx2(float* x, float* y, const float* vx, const float* vy, size_t n, float dt) {
+    const __m256 dtv = _mm256_set1_ps(dt);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_fmadd_ps(_mm256_loadu_ps(vx + i), dtv, _mm256_loadu_ps(x + i)));
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(_mm256_loadu_ps(vy + i), dtv, _mm256_loadu_ps(y + i)));
+    }
+    IntegrateScalar(x, y, vx, vy, i, n, dt);
+}
+#endif
+
+SimdLevel DetectSimdLevel() {
+#if SIMD_X86
+    if (SDL_HasAVX2() && CpuHasFma()) return SIMD_AVX2;
+    if (SDL_HasSSE2()) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+static SimdLevel& ActiveLevel() {
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+SimdLevel GetSimdLevel() {
+    return ActiveLevel();
+}
+
+void SetSimdLevel(SimdLevel level) {
+    SimdLevel best = DetectSimdLevel();
+    ActiveLevel() = level > best ? best : level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX2: return "AVX2+FMA";
+        case SIMD_SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+bool ParseSimdLevel(const char* name, SimdLevel& level) {
+    std::string s = name;
+    if (s == "scalar") level = SIMD_SCALAR;
+    else if (s == "sse2") level = SIMD_SSE2;
+    else if (s == "avx2") level = SIMD_AVX2;
+    else return false;
+    return true;
+}
+
+void ChaseKernel(float* x, float* y, const float* w, const float* h, const Uint8* type, size_t n,
+                 const float* stepByType, const float* aimX, const float* aimY, const float* pushX, const float* pushY) {
+    switch (ActiveLevel()) {
+#if SIMD_X86
+        case SIMD_AVX2: ChaseAvx2(x, y, w, h, type, n, stepByType, aimX, aimY, pushX, pushY); return;
+        case SIMD_SSE2: ChaseSse2(x, y, w, h, type, n, stepByType, aimX, aimY, pushX, pushY); return;
+#endif
+        default: ChaseScalar(x, y, w, h, type, 0, n, stepByType, aimX, aimY, pushX, pushY); return;
+    }
+}
+
+void IntegrateKernel(float* x, float* y, const float* vx, const float* vy, size_t n, float dt) {
+    switch (ActiveLevel()) {
+#if SIMD_X86
+        case SIMD_AVX2: IntegrateAvx2(x, y, vx, vy, n, dt); return;
+        case SIMD_SSE2: IntegrateSse2(x, y, vx, vy, n, dt); return;
+#endif
+        default: IntegrateScalar(x, y, vx, vy, 0, n, dt); return;
+    }
+}
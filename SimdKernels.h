@@ -0,0 +1,22 @@
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+
+enum SimdLevel { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 };
+
+// Best level this CPU supports; picked once on first use of a kernel
+SimdLevel DetectSimdLevel();
+SimdLevel GetSimdLevel();
+void SetSimdLevel(SimdLevel level);
+const char* SimdLevelName(SimdLevel level);
+// "scalar", "sse2" or "avx2"; false for anything else
+bool ParseSimdLevel(const char* name, SimdLevel& level);
+
+// Moves every entity stepByType[type] pixels along its heading: the unit vector from its center
+// toward (aimX, aimY), plus (pushX, pushY), renormalized. A step of 0 or less, or a heading
+// that cancels out, leaves it in place. stepByType needs an entry for every type present.
+// Positions are top-left corners.
+void ChaseKernel(float* x, float* y, const float* w, const float* h, const Uint8* type, size_t n,
+                 const float* stepByType, const float* aimX, const float* aimY, const float* pushX, const float* pushY);
+// x += vx * dt, y += vy * dt
+void IntegrateKernel(float* x, float* y, const float* vx, const float* vy, size_t n, float dt);
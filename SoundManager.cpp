@@ -0,0 +1,112 @@
+#include "SoundManager.h"
+#include <atomic>
+
+struct SoundDef {
+    Uint8 priority;         // higher wins a voice
+    Uint32 minGapMs;        // since the last play of the same sound
+};
+
+static const SoundDef soundDefs[SOUND_COUNT] = {
+    { 1, 80 },      // SOUND_WRONG
+    { 3, 0 },       // SOUND_GAMEOVER
+    { 3, 0 },       // SOUND_VICTORY
+    { 0, 50 },      // SOUND_CORRECT
+};
+
+struct Voice {
+    Uint8 priority = 0;
+    Uint32 startedAt = 0;
+    Uint32 endsAt = 0;      // from the chunk length, so finding a free voice needs no mixer lock
+};
+
+// Single-producer/single-consumer ring: the sim thread writes requestTail, the main thread requestHead
+const Uint32 requestCapacity = 64;
+static Uint8 requests[requestCapacity];
+static std::atomic<Uint32> requestHead(0);
+static std::atomic<Uint32> requestTail(0);
+static std::atomic<Uint32> queueFull(0);
+
+static Mix_Chunk* chunks[SOUND_COUNT] = {};
+static Uint32 chunkMs[SOUND_COUNT] = {};
+static Uint32 lastPlayed[SOUND_COUNT] = {};
+static bool everPlayed[SOUND_COUNT] = {};
+static Voice voices[soundVoices];
+static SoundStats stats = {};
+
+void InitSoundManager() {
+    Mix_AllocateChannels(soundVoices);
+}
+
+void SetSoundChunk(GameSound sound, Mix_Chunk* chunk) {
+    chunks[sound] = chunk;
+    chunkMs[sound] = 0;
+    int frequency = 0, channels = 0;
+    Uint16 format = 0;
+    if (!chunk || !Mix_QuerySpec(&frequency, &format, &channels)) return;
+    Uint32 bytesPerSecond = (Uint32)frequency * channels * (SDL_AUDIO_BITSIZE(format) / 8);
+    if (bytesPerSecond) chunkMs[sound] = (Uint32)((Uint64)chunk->alen * 1000 / bytesPerSecond);
+}
+
+void QueueGameSound(GameSound sound) {
+    Uint32 tail = requestTail.load(std::memory_order_relaxed);
+    if (tail - requestHead.load(std::memory_order_acquire) == requestCapacity) {
+        queueFull.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    requests[tail % requestCapacity] = (Uint8)sound;
+    requestTail.store(tail + 1, std::memory_order_release);
+}
+
+// A free voice, else the lowest-priority one (oldest first) that `priority` may cut off; -1 if none
+static int PickVoice(Uint8 priority, Uint32 now) {
+    int victim = -1;
+    for (int v = 0; v < soundVoices; v++) {
+        if (voices[v].endsAt <= now) return v;
+        if (voices[v].priority > priority) continue;
+        if (victim < 0 || voices[v].priority < voices[victim].priority ||
+            (voices[v].priority == voices[victim].priority && voices[v].startedAt < voices[victim].startedAt)) {
+            victim = v;
+        }
+    }
+    return victim;
+}
+
+static void PlaySound(GameSound sound, Uint32 now) {
+    const SoundDef& def = soundDefs[sound];
+    if (!chunks[sound]) return;
+    if (everPlayed[sound] && now - lastPlayed[sound] < def.minGapMs) {
+        stats.rateLimited++;
+        return;
+    }
+    int v = PickVoice(def.priority, now);
+    if (v < 0) {
+        stats.overBudget++;
+        return;
+    }
+    if (voices[v].endsAt > now) stats.stolen++;
+    // Playing on a busy channel replaces what it was playing
+    if (Mix_PlayChannel(v, chunks[sound], 0) < 0) return;
+    voices[v].priority = def.priority;
+    voices[v].startedAt = now;
+    voices[v].endsAt = now + chunkMs[sound];
+    lastPlayed[sound] = now;
+    everPlayed[sound] = true;
+    stats.played++;
+}
+
+void UpdateSoundManager() {
+    Uint32 now = SDL_GetTicks();
+    Uint32 head = requestHead.load(std::memory_order_relaxed);
+    Uint32 tail = requestTail.load(std::memory_order_acquire);
+    for (; head != tail; head++) PlaySound((GameSound)requests[head % requestCapacity], now);
+    requestHead.store(head, std::memory_order_release);
+}
+
+SoundStats GetSoundStats() {
+    SoundStats result = stats;
+    Uint32 now = SDL_GetTicks();
+    result.activeVoices = 0;
+    for (const Voice& voice : voices) result.activeVoices += voice.endsAt > now;
+    result.queueFull = queueFull.load(std::memory_order_relaxed);
+    return result;
+}
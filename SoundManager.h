@@ -0,0 +1,34 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include "Game.h"
+
+// Sound effects under a fixed voice budget. The simulation only queues requests, through a
+// lock-free single-producer ring, so a tick never waits on SDL_mixer's audio lock; the main
+// thread drains the ring once a frame and owns every mixer call.
+//
+// Each sound has a priority and a minimum gap between plays: a repeat inside the gap is
+// dropped, so a burst of hits in a big wave costs one voice. When every voice is busy a new
+// sound takes over the lowest-priority voice (the oldest of those), unless all of them
+// outrank it, in which case the request is dropped.
+
+const int soundVoices = 8;
+
+struct SoundStats {
+    int activeVoices;
+    Uint32 played;
+    Uint32 stolen;          // played by cutting off a lower- or equal-priority voice
+    Uint32 rateLimited;     // dropped: the same sound played too recently
+    Uint32 overBudget;      // dropped: every voice busy with something more important
+    Uint32 queueFull;       // dropped: the sim queued more than the ring holds between frames
+};
+
+// Reserves the mixer channels; call after Mix_OpenAudio
+void InitSoundManager();
+// Sets or replaces the chunk behind a sound; sounds without one are ignored. Main thread.
+void SetSoundChunk(GameSound sound, Mix_Chunk* chunk);
+// Any one producer thread at a time (the sim thread); never blocks
+void QueueGameSound(GameSound sound);
+// Main thread, once a frame: plays what was queued since the last call
+void UpdateSoundManager();
+SoundStats GetSoundStats();
@@ -0,0 +1,73 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+void InitGrid(SpatialGrid& grid, int width, int height, int cellSize) {
+    grid.cellSize = cellSize;
+    grid.cols = (width + cellSize - 1) / cellSize;
+    grid.rows = (height + cellSize - 1) / cellSize;
+    grid.cellStart.assign(grid.cols * grid.rows + 1, 0);
+    grid.cursor.assign(grid.cols * grid.rows, 0);
+    grid.rects.clear();
+    grid.cellItems.clear();
+}
+
+// Cell range covered by a rect, clamped so off-screen items land in the border cells
+static void CellRange(const SpatialGrid& grid, const SDL_Rect& r, int& x0, int& y0, int& x1, int& y1) {
+    x0 = std::clamp(r.x / grid.cellSize, 0, grid.cols - 1);
+    y0 = std::clamp(r.y / grid.cellSize, 0, grid.rows - 1);
+    x1 = std::clamp((r.x + r.w - 1) / grid.cellSize, 0, grid.cols - 1);
+    y1 = std::clamp((r.y + r.h - 1) / grid.cellSize, 0, grid.rows - 1);
+}
+
+void BeginGrid(SpatialGrid& grid) {
+    grid.rects.clear();
+}
+
+int AddToGrid(SpatialGrid& grid, const SDL_Rect& rect) {
+    grid.rects.push_back(rect);
+    return (int)grid.rects.size() - 1;
+}
+
+void EndGrid(SpatialGrid& grid) {
+    // Counting sort: count items per cell, prefix-sum into offsets, then scatter
+    std::fill(grid.cellStart.begin(), grid.cellStart.end(), 0);
+    int x0, y0, x1, y1;
+    for (const SDL_Rect& r : grid.rects) {
+        CellRange(grid, r, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++)
+            for (int cx = x0; cx <= x1; cx++)
+                grid.cellStart[cy * grid.cols + cx + 1]++;
+    }
+    for (size_t c = 1; c < grid.cellStart.size(); c++) grid.cellStart[c] += grid.cellStart[c - 1];
+
+    grid.cellItems.resize(grid.cellStart.back());
+    std::copy(grid.cellStart.begin(), grid.cellStart.end() - 1, grid.cursor.begin());
+    for (int id = 0; id < (int)grid.rects.size(); id++) {
+        CellRange(grid, grid.rects[id], x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++)
+            for (int cx = x0; cx <= x1; cx++)
+                grid.cellItems[grid.cursor[cy * grid.cols + cx]++] = id;
+    }
+    if (grid.seen.size() < grid.rects.size()) grid.seen.resize(grid.rects.size(), 0);
+}
+
+void QueryGrid(SpatialGrid& grid, const SDL_Rect& area, std::vector<int>& out) {
+    if (grid.rects.empty()) return;
+    if (++grid.queryStamp == 0) {
+        std::fill(grid.seen.begin(), grid.seen.end(), 0);
+        grid.queryStamp = 1;
+    }
+    int x0, y0, x1, y1;
+    CellRange(grid, area, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int cell = cy * grid.cols + cx;
+            for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; k++) {
+                int id = grid.cellItems[k];
+                if (grid.seen[id] == grid.queryStamp) continue;
+                grid.seen[id] = grid.queryStamp;
+                if (SDL_HasIntersection(&grid.rects[id], &area)) out.push_back(id);
+            }
+        }
+    }
+}
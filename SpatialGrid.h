@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Uniform grid over the arena, rebuilt from scratch every tick.
+// Items are referenced by the index they were added with, so callers can map hits
+// straight back into their own arrays.
+struct SpatialGrid {
+    int cellSize = 64;
+    int cols = 0, rows = 0;
+    std::vector<SDL_Rect> rects;    // rect per item id
+    std::vector<int> cellStart;     // cols*rows+1 offsets into cellItems
+    std::vector<int> cellItems;     // item ids grouped by cell
+    std::vector<int> cursor;        // scratch for the counting sort
+    std::vector<unsigned> seen;     // per-item stamp so a query reports each item once
+    unsigned queryStamp = 0;
+};
+
+void InitGrid(SpatialGrid& grid, int width, int height, int cellSize);
+void BeginGrid(SpatialGrid& grid);
+int AddToGrid(SpatialGrid& grid, const SDL_Rect& rect);
+void EndGrid(SpatialGrid& grid);
+// Appends the ids of every item whose rect overlaps `area`
+void QueryGrid(SpatialGrid& grid, const SDL_Rect& area, std::vector<int>& out);
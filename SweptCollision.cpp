@@ -0,0 +1,56 @@
+#include "SweptCollision.h"
+#include <algorithm>
+#include <cmath>
+
+SweptBox EntitySweep(const EntityStore& store, size_t index) {
+    return { floorf(store.prevX[index]), floorf(store.prevY[index]), floorf(store.x[index]), floorf(store.y[index]),
+             (float)(int)store.w[index], (float)(int)store.h[index] };
+}
+
+SDL_Rect SweptBounds(const SweptBox& box) {
+    float left = std::min(box.x0, box.x1), top = std::min(box.y0, box.y1);
+    float right = std::max(box.x0, box.x1) + box.w, bottom = std::max(box.y0, box.y1) + box.h;
+    return { (int)left, (int)top, (int)(right - left), (int)(bottom - top) };
+}
+
+// Open interval of t where start + t * velocity lies strictly inside (low, high)
+static bool AxisOverlap(float start, float velocity, float low, float high, float& enter, float& exit) {
+    if (velocity == 0.0f) {
+        enter = -INFINITY;
+        exit = INFINITY;
+        return start > low && start < high;
+    }
+    float a = (low - start) / velocity;
+    float b = (high - start) / velocity;
+    enter = std::min(a, b);
+    exit = std::max(a, b);
+    return true;
+}
+
+float SweptOverlapTime(const SweptBox& a, const SweptBox& b) {
+    // Move in b's frame: a's offset from b at the start of the tick and how it changes
+    float relX = a.x0 - b.x0, relY = a.y0 - b.y0;
+    float velX = (a.x1 - a.x0) - (b.x1 - b.x0);
+    float velY = (a.y1 - a.y0) - (b.y1 - b.y0);
+    float enterX, exitX, enterY, exitY;
+    if (!AxisOverlap(relX, velX, -a.w, b.w, enterX, exitX)) return -1.0f;
+    if (!AxisOverlap(relY, velY, -a.h, b.h, enterY, exitY)) return -1.0f;
+    float enter = std::max(enterX, enterY);
+    float exit = std::min(exitX, exitY);
+    if (enter >= exit || enter >= 1.0f || exit <= 0.0f) return -1.0f;
+    return std::max(enter, 0.0f);
+}
+
+int FirstSweptHit(const EntityStore& store, const std::vector<int>& candidates, const SweptBox& target) {
+    int first = -1;
+    float firstTime = 0.0f;
+    for (int id : candidates) {
+        float t = SweptOverlapTime(EntitySweep(store, id), target);
+        if (t < 0.0f) continue;
+        if (first < 0 || t < firstTime || (t == firstTime && id < first)) {
+            first = id;
+            firstTime = t;
+        }
+    }
+    return first;
+}
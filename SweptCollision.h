@@ -0,0 +1,26 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "EntityStore.h"
+
+// Continuous collision for boxes that move in a straight line over one tick. Testing only
+// where things end up lets a fast bullet (or a long tick) skip clean over the player; a
+// sweep catches every overlap along the way, with no sub-stepping.
+
+// A box over one tick: its top-left at the previous tick and now. Positions are floored
+// like EntityRect, so at either end the sweep agrees with SDL_HasIntersection on the rects.
+struct SweptBox {
+    float x0, y0;
+    float x1, y1;
+    float w, h;
+};
+
+SweptBox EntitySweep(const EntityStore& store, size_t index);
+// Smallest rect covering the box over the whole tick; what goes into the broad-phase grid
+SDL_Rect SweptBounds(const SweptBox& box);
+// Fraction of the tick, in [0, 1), at which the boxes first overlap, or -1 if they never do.
+// Uses the relative motion, so both boxes may be moving.
+float SweptOverlapTime(const SweptBox& a, const SweptBox& b);
+// Narrow phase over broad-phase candidates (dense indices into store): the entity that
+// reaches target first, the lowest index on ties, or -1
+int FirstSweptHit(const EntityStore& store, const std::vector<int>& candidates, const SweptBox& target);
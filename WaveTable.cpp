@@ -0,0 +1,150 @@
+#include "WaveTable.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+static void SetArchetype(EnemyArchetype& a, const char* name, float speed, float size, Uint32 fireInterval,
+                         float bulletSpeed, int scoreValue, SDL_Color color) {
+    memset(&a, 0, sizeof(a));
+    strncpy(a.name, name, sizeof(a.name) - 1);
+    a.speed = speed;
+    a.w = size;
+    a.h = size;
+    a.fireInterval = fireInterval;
+    a.bulletSpeed = bulletSpeed;
+    a.scoreValue = scoreValue;
+    a.color = color;
+}
+
+WaveTable DefaultWaveTable() {
+    WaveTable table = {};
+    SetArchetype(table.archetypes[0], "slow", 80.0f, 32.0f, 0, 0.0f, 5, { 0, 128, 255, 255 });
+    SetArchetype(table.archetypes[1], "fast", 80.0f, 32.0f, 0, 0.0f, 5, { 255, 0, 0, 255 });
+    SetArchetype(table.archetypes[2], "ranged", 0.0f, 32.0f, 2000, 200.0f, 5, { 255, 255, 0, 255 });
+    table.archetypeCount = 3;
+    WaveDef wave = {};
+    wave.duration = 3000;
+    wave.count = 3;
+    for (int i = 0; i < 3; i++) wave.weights[i] = 1;
+    wave.totalWeight = 3;
+    table.waves.push_back(wave);
+    table.afterLast = WAVES_REPEAT;
+    table.repeatGrowth = 3;
+    table.speedPerLevel = 15.0f;
+    return table;
+}
+
+bool ParseWaveTable(const char* text, WaveTable& table, std::string& error) {
+    WaveTable parsed = {};
+    bool haveEnd = false;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    auto fail = [&](const char* what) {
+        error = "line " + std::to_string(lineNumber) + ": " + what;
+        return false;
+    };
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key)) continue;
+
+        if (key == "speed_per_level") {
+            if (!(in >> parsed.speedPerLevel) || parsed.speedPerLevel < 0) return fail("expected speed_per_level <pixels per second>");
+        } else if (key == "enemy") {
+            if (parsed.archetypeCount == maxArchetypes) return fail("too many enemy archetypes");
+            if (!parsed.waves.empty()) return fail("enemy lines must come before the first wave");
+            std::string name;
+            float speed, w, h, bulletSpeed;
+            Uint32 fireInterval;
+            int scoreValue, r, g, b;
+            if (!(in >> name >> speed >> w >> h >> fireInterval >> bulletSpeed >> scoreValue >> r >> g >> b)) {
+                return fail("expected enemy <name> <speed> <w> <h> <fire ms> <bullet speed> <score> <r> <g> <b>");
+            }
+            if (speed < 0 || w <= 0 || h <= 0 || w > 400 || h > 300) return fail("bad enemy speed or size");
+            if (fireInterval > 0 && bulletSpeed <= 0) return fail("an enemy that fires needs a bullet speed");
+            EnemyArchetype& a = parsed.archetypes[parsed.archetypeCount++];
+            SetArchetype(a, name.c_str(), speed, w, fireInterval, bulletSpeed, scoreValue,
+                         { (Uint8)r, (Uint8)g, (Uint8)b, 255 });
+            a.h = h;
+        } else if (key == "wave") {
+            WaveDef wave = {};
+            if (!(in >> wave.duration >> wave.count) || wave.count < 0) return fail("expected wave <duration ms> <count> <weights...>");
+            if (wave.duration == 0) return fail("a wave needs a duration");
+            int weight, n = 0;
+            while (in >> weight) {
+                if (n == parsed.archetypeCount) return fail("more weights than enemy archetypes");
+                if (weight < 0) return fail("negative weight");
+                wave.weights[n++] = weight;
+                wave.totalWeight += weight;
+            }
+            if (!in.eof()) return fail("bad weight");
+            if (wave.totalWeight == 0) return fail("a wave needs at least one non-zero weight");
+            parsed.waves.push_back(wave);
+        } else if (key == "after_last") {
+            std::string mode;
+            in >> mode;
+            if (mode == "victory") {
+                parsed.afterLast = WAVES_VICTORY;
+            } else if (mode == "repeat" && in >> parsed.repeatGrowth && parsed.repeatGrowth >= 0) {
+                parsed.afterLast = WAVES_REPEAT;
+            } else {
+                return fail("expected after_last victory or after_last repeat <extra enemies per wave>");
+            }
+            haveEnd = true;
+        } else {
+            return fail(("unknown keyword " + key).c_str());
+        }
+    }
+    if (parsed.archetypeCount == 0) return fail("no enemy lines");
+    if (parsed.waves.empty()) return fail("no wave lines");
+    if (!haveEnd) return fail("no after_last line");
+    table = parsed;
+    return true;
+}
+
+bool LoadWaveTable(const char* path, WaveTable& table, std::string& error, std::string* source) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open file";
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if (!ParseWaveTable(text.str().c_str(), table, error)) return false;
+    if (source) *source = text.str();
+    return true;
+}
+
+const WaveDef* WaveFor(const WaveTable& table, int wave, int& count) {
+    int rows = (int)table.waves.size();
+    if (wave <= rows) {
+        const WaveDef& def = table.waves[std::max(wave, 1) - 1];
+        count = def.count;
+        return &def;
+    }
+    if (table.afterLast == WAVES_VICTORY) return nullptr;
+    const WaveDef& last = table.waves.back();
+    count = last.count + table.repeatGrowth * (wave - rows);
+    return &last;
+}
+
+bool FileChanged(FileWatch& watch) {
+    struct stat info;
+    long long mtime = -1, size = -1;
+    if (stat(watch.path.c_str(), &info) == 0) {
+        mtime = (long long)info.st_mtime;
+        size = (long long)info.st_size;
+    }
+    // mtime often only has whole seconds, so the size also catches a second save within one
+    if (mtime == watch.mtime && size == watch.size) return false;
+    watch.mtime = mtime;
+    watch.size = size;
+    return true;
+}
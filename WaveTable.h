@@ -0,0 +1,57 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+// Enemy archetypes and the wave schedule, loaded from assets/waves.txt. The entity type
+// stored with each enemy is its archetype's index, so the update loops look everything up
+// in flat per-type arrays instead of switching on the type.
+const int maxArchetypes = 16;
+
+struct EnemyArchetype {
+    char name[16];
+    float speed;            // pixels per second toward the player; 0 holds position
+    float w, h;
+    Uint32 fireInterval;    // ms between shots; 0 never fires
+    float bulletSpeed;      // pixels per second
+    int scoreValue;         // awarded when it leaves the arena
+    SDL_Color color;
+};
+
+struct WaveDef {
+    Uint32 duration;        // ms before the next wave starts
+    int count;
+    int weights[maxArchetypes];    // relative odds of each archetype per spawn
+    int totalWeight;
+};
+
+enum WaveEnd { WAVES_REPEAT, WAVES_VICTORY };
+
+struct WaveTable {
+    EnemyArchetype archetypes[maxArchetypes];
+    int archetypeCount = 0;
+    std::vector<WaveDef> waves;
+    WaveEnd afterLast = WAVES_REPEAT;
+    int repeatGrowth = 0;   // WAVES_REPEAT: extra enemies per wave past the last row
+    float speedPerLevel = 0.0f;
+};
+
+// The built-in table, used when the file is missing: the original three enemies, three
+// more of them every wave, forever
+WaveTable DefaultWaveTable();
+// Parses the text format documented in assets/waves.txt. On failure returns false, leaves
+// `table` untouched and describes the first bad line in `error`.
+bool ParseWaveTable(const char* text, WaveTable& table, std::string& error);
+// `source`, if given, receives the file's text, so a recording can carry the exact table
+bool LoadWaveTable(const char* path, WaveTable& table, std::string& error, std::string* source = nullptr);
+// The row for a 1-based wave number, or null once a WAVES_VICTORY table has run out.
+// Past the last row of a WAVES_REPEAT table, `count` is the enemies that wave spawns.
+const WaveDef* WaveFor(const WaveTable& table, int wave, int& count);
+
+// Polls a file's modification time; true when it differs from the last poll
+struct FileWatch {
+    std::string path;
+    long long mtime = -1;
+    long long size = -1;
+};
+bool FileChanged(FileWatch& watch);
@@ -0,0 +1,293 @@
+#include <SDL.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../Game.h"
+#include "../JobSystem.h"
+#include "../AllocCounter.h"
+
+// Windowless benchmark of the simulation hot paths. Sweeps entity counts and enemy type
+// mixes and writes one JSON record per case, so runs can be diffed between commits.
+
+enum Mix { MIX_CHASERS, MIX_RANGED, MIX_MIXED, MIX_RANDOM };
+static const char* mixNames[] = { "chasers", "ranged", "mixed", "random" };
+
+struct BenchResult {
+    const char* name;
+    const char* mix;
+    int entities;
+    Uint64 ticks;
+    double nsPerEntityTick;
+    double allocsPerTick;
+    bool steadyState;       // a tick of running gameplay, which must not allocate once warmed up
+};
+
+static std::vector<BenchResult> results;
+static double minSeconds = 0.05;   // keep repeating batches until this much time was measured
+
+static double Seconds(Uint64 start, Uint64 end) {
+    return (double)(end - start) / SDL_GetPerformanceFrequency();
+}
+
+static void ResetGame(Uint64 seed) {
+    SeedRng(gameRng, seed);
+    simClock.tick = 0;
+    StartNewGame();
+    ClearEntities(enemies);
+    ClearEntities(projectiles);
+}
+
+// Types drawn by SpawnEnemy are overwritten so every run of a mix sees the same proportions
+static void FillEnemies(int count, Mix mix) {
+    ClearEntities(enemies);
+    ReserveEntities(enemies, count);
+    for (int i = 0; i < count; i++) {
+        SpawnEnemy(800, 600);
+        if (mix == MIX_CHASERS) enemies.type[i] = (Uint8)(i % 2 == 0 ? SLOW : FAST);
+        else if (mix == MIX_RANGED) enemies.type[i] = RANGED;
+        else if (mix == MIX_MIXED) enemies.type[i] = (Uint8)(i % 3);
+    }
+    RebuildEnemyGrid();
+}
+
+static void FillProjectiles(int count) {
+    ClearEntities(projectiles);
+    ReservePool(projectilePool, count);
+    float speed = waveTable.archetypes[RANGED].bulletSpeed;
+    for (int i = 0; i < count; i++) {
+        float angle = RandomInt(gameRng, 360) * 3.14159f / 180.0f;
+        SpawnProjectile(projectilePool, (float)RandomInt(gameRng, 792), (float)RandomInt(gameRng, 592), 8, 8,
+                        cosf(angle) * speed, sinf(angle) * speed);
+    }
+}
+
+static void Record(const char* name, Mix mix, int entities, Uint64 ticks, double seconds, Uint64 allocs,
+                   bool steadyState) {
+    BenchResult r = { name, mixNames[mix], entities, ticks,
+                      seconds * 1e9 / ((double)entities * ticks), (double)allocs / ticks, steadyState };
+    results.push_back(r);
+    fprintf(stderr, "%-18s %-8s %7d  %9.2f ns/entity/tick  %8.3f allocs/tick\n",
+            r.name, r.mix, r.entities, r.nsPerEntityTick, r.allocsPerTick);
+}
+
+// Each timed call spawns `count` enemies into an empty, pre-reserved store
+static void BenchSpawnEnemy(int count) {
+    ResetGame(1);
+    ReserveEntities(enemies, count);
+    Uint64 calls = 0, allocs = 0;
+    double seconds = 0.0;
+    while (seconds < minSeconds || calls == 0) {
+        ClearEntities(enemies);
+        Uint64 allocStart = AllocationCount();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < count; i++) SpawnEnemy(800, 600);
+        seconds += Seconds(start, SDL_GetPerformanceCounter());
+        allocs += AllocationCount() - allocStart;
+        calls++;
+    }
+    Record("SpawnEnemy", MIX_RANDOM, count, calls, seconds, allocs, false);
+}
+
+// A wave of N enemies is wave N/3; a tick here is one StartWave call
+static void BenchStartWave(int count) {
+    ResetGame(2);
+    Uint64 calls = 0, allocs = 0;
+    double seconds = 0.0;
+    while (seconds < minSeconds || calls == 0) {
+        currentWave = std::max(1, count / 3);
+        Uint64 allocStart = AllocationCount();
+        Uint64 start = SDL_GetPerformanceCounter();
+        StartWave();
+        seconds += Seconds(start, SDL_GetPerformanceCounter());
+        allocs += AllocationCount() - allocStart;
+        calls++;
+    }
+    Record("StartWave", MIX_RANDOM, (int)EntityCount(enemies), calls, seconds, allocs, false);
+}
+
+// Runs batches of ticks from the same starting state, restoring it between batches
+static void BenchUpdateEnemies(int count, Mix mix) {
+    const int batchTicks = 16;
+    ResetGame(3);
+    FillEnemies(count, mix);
+    const EnemyArchetype& ranged = waveTable.archetypes[RANGED];
+    ReservePool(projectilePool, ProjectileCapacityForWave(count, ranged.fireInterval, ranged.bulletSpeed, 800, 600));
+    EntityStore snapshot = enemies;
+    Uint64 ticks = 0, allocs = 0;
+    double seconds = 0.0;
+    // The first batch is a warm-up: it grows scratch buffers to this size and is not counted
+    for (int batch = 0; batch == 0 || seconds < minSeconds || ticks == 0; batch++) {
+        enemies = snapshot;
+        ClearEntities(projectiles);
+        Uint64 allocStart = AllocationCount();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int t = 0; t < batchTicks; t++) {
+            ResetArena(tickArena);
+            AdvanceClock(simClock);
+            UpdateEnemies(simDt, 800, 600, playerRect);
+        }
+        if (batch == 0) continue;
+        seconds += Seconds(start, SDL_GetPerformanceCounter());
+        allocs += AllocationCount() - allocStart;
+        ticks += batchTicks;
+    }
+    Record("UpdateEnemies", mix, count, ticks, seconds, allocs, true);
+}
+
+static void BenchUpdateProjectiles(int count) {
+    const int batchTicks = 16;
+    ResetGame(4);
+    FillProjectiles(count);
+    EntityStore snapshot = projectiles;
+    Uint64 ticks = 0, allocs = 0;
+    double seconds = 0.0;
+    for (int batch = 0; batch == 0 || seconds < minSeconds || ticks == 0; batch++) {
+        projectiles = snapshot;
+        lives = 3;
+        isInvulnerable = false;
+        ClearEvents(gameEvents);
+        Uint64 allocStart = AllocationCount();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int t = 0; t < batchTicks; t++) {
+            AdvanceClock(simClock);
+            UpdateProjectiles(simDt, 800, 600);
+        }
+        if (batch == 0) continue;
+        seconds += Seconds(start, SDL_GetPerformanceCounter());
+        allocs += AllocationCount() - allocStart;
+        ticks += batchTicks;
+    }
+    Record("UpdateProjectiles", MIX_RANDOM, count, ticks, seconds, allocs, true);
+}
+
+// Every enemy is a shooter on its own cooldown, phased at random; a tick is one RunDueEvents,
+// so the cost follows the shots due that tick rather than the number of shooters
+static void BenchFireTimers(int count) {
+    const int batchTicks = 120;
+    ResetGame(5);
+    FillEnemies(count, MIX_RANGED);
+    const EnemyArchetype& ranged = waveTable.archetypes[RANGED];
+    ReservePool(projectilePool, ProjectileCapacityForWave(count, ranged.fireInterval, ranged.bulletSpeed, 800, 600));
+    ClearEvents(gameEvents);
+    ScheduleFirstShots();
+    Uint64 ticks = 0, allocs = 0;
+    double seconds = 0.0;
+    // The clock keeps running across batches; the first one covers every first shot and is not counted
+    for (int batch = 0; batch == 0 || seconds < minSeconds || ticks == 0; batch++) {
+        ClearEntities(projectiles);
+        Uint64 allocStart = AllocationCount();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int t = 0; t < batchTicks; t++) {
+            AdvanceClock(simClock);
+            RunDueEvents();
+        }
+        if (batch == 0) continue;
+        seconds += Seconds(start, SDL_GetPerformanceCounter());
+        allocs += AllocationCount() - allocStart;
+        ticks += batchTicks;
+    }
+    Record("FireTimers", MIX_RANGED, count, ticks, seconds, allocs, true);
+}
+
+static void WriteJson(FILE* out) {
+    fprintf(out, "{\n  \"simd\": \"%s\",\n  \"job_workers\": %d,\n  \"results\": [\n",
+            SimdLevelName(GetSimdLevel()), JobWorkerCount());
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "    { \"name\": \"%s\", \"mix\": \"%s\", \"entities\": %d, \"ticks\": %llu, "
+                     "\"ns_per_entity_tick\": %.3f, \"allocs_per_tick\": %.3f }%s\n",
+                r.name, r.mix, r.entities, (unsigned long long)r.ticks, r.nsPerEntityTick, r.allocsPerTick,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+// Whole-string parses; false on empty input, trailing junk or overflow
+static bool ParseInt(const char* text, int& value) {
+    char* end;
+    errno = 0;
+    long v = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || v < INT_MIN || v > INT_MAX) return false;
+    value = (int)v;
+    return true;
+}
+
+static bool ParseDouble(const char* text, double& value) {
+    char* end;
+    errno = 0;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0' && errno != ERANGE;
+}
+
+int main(int argc, char* argv[]) {
+    const char* outPath = nullptr;
+    int maxEntities = 100000;
+    bool failOnAlloc = false;
+    int threads = -1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--max-entities" && i + 1 < argc) ok = ParseInt(argv[++i], maxEntities) && maxEntities >= 10;
+        else if (arg == "--min-seconds" && i + 1 < argc) ok = ParseDouble(argv[++i], minSeconds) && minSeconds > 0;
+        else if (arg == "--fail-on-alloc") failOnAlloc = true;
+        else if (arg == "--threads" && i + 1 < argc) ok = ParseInt(argv[++i], threads) && threads >= 0;
+        else if (arg == "--simd" && i + 1 < argc) {
+            SimdLevel level;
+            ok = ParseSimdLevel(argv[++i], level);
+            if (ok && level > DetectSimdLevel()) {
+                fprintf(stderr, "--simd: this CPU lacks %s, using %s\n", SimdLevelName(level), SimdLevelName(DetectSimdLevel()));
+                level = DetectSimdLevel();
+            }
+            if (ok) SetSimdLevel(level);
+        } else {
+            fprintf(stderr, "Unknown or incomplete argument: %s\n", argv[i]);
+            return 1;
+        }
+        if (!ok) {
+            fprintf(stderr, "Bad value for %s: %s (--max-entities >= 10, --min-seconds > 0, --threads >= 0, "
+                            "--simd scalar|sse2|avx2)\n", argv[i - 1], argv[i]);
+            return 1;
+        }
+    }
+    if (threads >= 0) StartJobSystem(threads);
+    if (!AllocationCountingEnabled()) {
+        fprintf(stderr, "Allocations are not counted in this build; add -DCOUNT_ALLOCATIONS\n");
+        if (failOnAlloc) return 1;
+    }
+    persistHighScore = false;
+    InitGrid(enemyGrid, 800, 600, 64);
+    InitGrid(projectileGrid, 800, 600, 64);
+
+    for (int count = 10; count <= maxEntities; count *= 10) {
+        BenchSpawnEnemy(count);
+        BenchStartWave(count);
+        BenchUpdateEnemies(count, MIX_CHASERS);
+        BenchUpdateEnemies(count, MIX_RANGED);
+        BenchUpdateEnemies(count, MIX_MIXED);
+        BenchUpdateProjectiles(count);
+        BenchFireTimers(count);
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", outPath);
+        return 1;
+    }
+    WriteJson(out);
+    if (out != stdout) fclose(out);
+
+    // Spawning and wave starts may grow buffers; a warmed-up gameplay tick may not
+    int allocating = 0;
+    for (const BenchResult& r : results) {
+        if (!r.steadyState || r.allocsPerTick == 0.0) continue;
+        fprintf(stderr, "ALLOCATES: %s %s %d, %.3f allocs/tick\n", r.name, r.mix, r.entities, r.allocsPerTick);
+        allocating++;
+    }
+    return failOnAlloc && allocating > 0 ? 1 : 0;
+}
@@ -9,135 +9,106 @@
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <cstring>
+#include "Game.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
+#include "GlyphAtlas.h"
+#include "RenderBatch.h"
+#include "Replay.h"
+#include "SimThread.h"
+#include "FramePacer.h"
+#include "SoundManager.h"
+#include "FrameArena.h"
+#include "AllocCounter.h"
 struct Button {
     SDL_Rect rect;
     SDL_Color color;
     std::string text;
+    TextLabel label;
 };
-enum EnemyType{SLOW, FAST, RANGED};
-struct Enemy {
-    SDL_Rect rect;
-    float vx, vy;
-    EnemyType type;
-};
-struct Projectile {
-    SDL_Rect rect;
-    float vx, vy;
-};
-// Game states
-enum GameState { MENU, PLAYING, PAUSED, GAME_OVER, VICTORY };
 
-GameState gameState = MENU;
-int score = 0;
-int lives = 3;
-int level = 1;
 SDL_Texture* heartTex = nullptr;
-
-int highScore = 0;
-SDL_Rect playerRect = { 368,300,64,64 };
-SDL_Rect itemRect = { 400,400,32,32 };
+GlyphAtlas glyphAtlas;
+QuadBatch textBatch;
+QuadBatch shapeBatch;   // enemies and projectiles, one solid-color geometry call per frame
+QuadBatch heartBatch;
 SDL_Texture* itemTex = nullptr;
-const int playerSpeed = 50;
-
-Uint32 gameStartTime = 0;
-int timeLimit = 30;
-
-std::vector<Enemy> enemies;
-int enemiesPerLevel = 2;
-float enemyBaseSpeed = 80.0f;
-
-bool isInvulnerable = false;
-Uint32 invulnerableStart = 0;
-const int invulnerableDuration = 1000; //ms
-
-int currentWave = 1;
-int enemiesToSpawn = 0;
-bool waveInProgress = false;
-Uint32 waveStartTime = 0;
-Uint32 lastWaveTime = 0;
-Uint32 waveDelay = 3000; //ms
 
-std::vector<Projectile> projectiles;
-Uint32 lastShootTime = 0;
-Uint32 shootInterval = 2000; //ms
+Button playButton = { playButtonRect, {0,120,255,255}, "PLAY", {} };
+Button restartButton = { restartButtonRect, {0,200,100,255}, "RESTART", {} };
+
+bool recordingInput = false;
+Replay recording;
+
+bool showProfiler = false;
+// Strings and other scratch for the frame being drawn; reset at the end of every loop iteration
+FrameArena frameArena;
+// Heap allocations seen during the last frame, from any thread, and how many gameplay frames had any
+Uint64 lastFrameAllocs = 0;
+Uint32 playingFrames = 0;
+Uint32 allocatingFrames = 0;
+// Longest a menu or end screen sleeps on the event queue; input wakes it sooner
+const int idleWaitMs = 250;
+bool audioEnabled = false;
+bool musicStarted = false;
+bool musicPaused = false;
+
+// Music runs through a game: it starts with play, holds while paused and stops on the other screens
+void UpdateMusic(Mix_Music* music, GameState state) {
+    if (!audioEnabled || !music) return;
+    if (state == PLAYING && !musicStarted) {
+        musicStarted = Mix_PlayMusic(music, -1) == 0;
+        musicPaused = false;
+    } else if (musicStarted && (state == PLAYING || state == PAUSED)) {
+        if (musicPaused != (state == PAUSED)) {
+            musicPaused = state == PAUSED;
+            if (musicPaused) Mix_PauseMusic();
+            else Mix_ResumeMusic();
+        }
+    } else if (musicStarted) {
+        Mix_HaltMusic();
+        musicStarted = false;
+    }
+}
 
-bool Init(SDL_Window** window, SDL_Renderer** renderer, int w, int h) {
+bool Init(SDL_Window** window, SDL_Renderer** renderer, int w, int h, bool vsync) {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) return false;
     if (TTF_Init() == -1) return false;
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) return false;
+    audioEnabled = true;
+    InitSoundManager();
 
     *window = SDL_CreateWindow("Etapa 10", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, w, h, SDL_WINDOW_SHOWN);
-    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED);
+    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
     return *window && *renderer;
 }
 
-SDL_Texture* LoadTexture(const std::string& path, SDL_Renderer* renderer) {
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
-        std::cerr << "Error loading texture: " << path << std::endl;
-        return nullptr;
-    }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    return texture;
-}
-
-SDL_Texture* RenderText(const std::string& msg, TTF_Font* font, SDL_Color color, SDL_Renderer* renderer) {
-    SDL_Surface* surface = TTF_RenderText_Blended(font, msg.c_str(), color);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    return texture;
-}
-
-void RenderHUD(SDL_Renderer* renderer, TTF_Font* font) {
+void RenderHUD(SDL_Renderer* renderer, QuadBatch& batch, const GameSnapshot& snap) {
+    static TextLabel scoreLabel, levelLabel, timeLabel, highLabel, waveLabel;
     SDL_Color white = { 255, 255, 255, 255 };
-    SDL_Texture* scoreTex = RenderText("Score: " + std::to_string(score), font, white, renderer);
-    SDL_Rect dest = { 20, 20, 0, 0 };
-    SDL_QueryTexture(scoreTex, nullptr, nullptr, &dest.w, &dest.h);
-    SDL_RenderCopy(renderer, scoreTex, nullptr, &dest);
-    SDL_DestroyTexture(scoreTex);
-
-    SDL_Texture* levelTex = RenderText("Level: " + std::to_string(level), font, white, renderer);
-    SDL_Rect lRect = { 200,100,0,0 };
-    SDL_QueryTexture(levelTex, nullptr, nullptr, &lRect.w, &lRect.h);
-    SDL_RenderCopy(renderer, levelTex, nullptr, &lRect);
-    SDL_DestroyTexture(levelTex);
-    for (int i = 0; i < lives; i++) {
-        SDL_Rect heartRect = { 20 + i * 40, 60, 32, 32 };
-        SDL_RenderCopy(renderer, heartTex, nullptr, &heartRect);
+    DrawLabel(batch, glyphAtlas, scoreLabel, "Score: ", snap.score, 20, 20, white);
+    DrawLabel(batch, glyphAtlas, levelLabel, "Level: ", snap.level, 200, 100, white);
+    SDL_FRect fullTexture = { 0.0f, 0.0f, 1.0f, 1.0f };
+    for (int i = 0; i < snap.lives; i++) {
+        AddQuad(heartBatch, (float)(20 + i * 40), 60.0f, 32.0f, 32.0f, white, fullTexture);
     }
+    FlushQuads(heartBatch, heartTex, renderer);
 
-    if (gameState == PLAYING) {
-        Uint32 now = SDL_GetTicks();
-        int timeLeft = timeLimit - (now - gameStartTime) / 1000;
-        if (timeLeft < 0) timeLeft = 0;
-
-        SDL_Texture* timeTex = RenderText("Time: " + std::to_string(timeLeft), font, white, renderer);
-        SDL_Rect tRect = { 700,20,0,0 };
-        SDL_QueryTexture(timeTex, nullptr, nullptr, &tRect.w, &tRect.h);
-        SDL_RenderCopy(renderer, timeTex, nullptr, &tRect);
-        SDL_DestroyTexture(timeTex);
+    if (snap.state == PLAYING) {
+        DrawLabel(batch, glyphAtlas, timeLabel, "Time: ", snap.timeLeft, 700, 20, white);
     }
 
-    SDL_Texture* highTex = RenderText("High Score: "+std::to_string(highScore), font, white, renderer);
-    SDL_Rect hRect = { 20,100,0,0 };
-    SDL_QueryTexture(highTex, nullptr, nullptr, &hRect.w, &hRect.h);
-    SDL_RenderCopy(renderer, highTex, nullptr, &hRect);
-    SDL_DestroyTexture(highTex);
-
-    SDL_Texture* waveTex = RenderText("Wave: " + std::to_string(currentWave), font, white, renderer);
-    SDL_Rect wRect = { 600,60,0,0 };
-    SDL_QueryTexture(waveTex, nullptr, nullptr, &wRect.w, &wRect.h);
-    SDL_RenderCopy(renderer, waveTex, nullptr, &wRect);
-    SDL_DestroyTexture(waveTex);
+    DrawLabel(batch, glyphAtlas, highLabel, "High Score: ", snap.highScore, 20, 100, white);
+    DrawLabel(batch, glyphAtlas, waveLabel, "Wave: ", snap.currentWave, 600, 60, white);
 }
 
-void RenderButton(SDL_Renderer* renderer, TTF_Font* font, Button btn, bool hovered) {
+void RenderButton(SDL_Renderer* renderer, QuadBatch& batch, Button& btn, bool hovered) {
     SDL_Color color;
     if (hovered) {
         color.r = (Uint8)std::min(255, btn.color.r + 40);
         color.g = (Uint8)std::min(255, btn.color.g + 40);
-        color.b = (Uint8)std::min(255, btn.color.a + 40);
+        color.b = (Uint8)std::min(255, btn.color.b + 40);
         color.a = 255;
     }else {
         color = btn.color;
@@ -150,162 +121,242 @@ void RenderButton(SDL_Renderer* renderer, TTF_Font* font, Button btn, bool hover
     SDL_RenderDrawRect(renderer, &btn.rect);
 
     SDL_Color white = { 255, 255, 255, 255 };
-    SDL_Texture* tex = RenderText(btn.text, font, white, renderer);
-    int texW = 0, texH = 0;
-    SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
-    SDL_Rect textRect{
-        btn.rect.x + (btn.rect.w - texW)/2,
-        btn.rect.y + (btn.rect.h - texH)/2,
-        texW, texH
-    };
-    SDL_RenderCopy(renderer, tex, nullptr, &textRect);
-    SDL_DestroyTexture(tex);
+    int texW = MeasureText(glyphAtlas, btn.text.c_str());
+    int texH = TextHeight(glyphAtlas);
+    DrawLabel(batch, glyphAtlas, btn.label, btn.text.c_str(),
+              btn.rect.x + (btn.rect.w - texW) / 2, btn.rect.y + (btn.rect.h - texH) / 2, white);
 }
 
-void LoadHighScore() {
-    std::ifstream file("score.txt");
-    if (file.is_open()) {
-        file >> highScore;
-        file.close();
+// Appends one quad per entity at its position interpolated between the last two ticks
+void AddEntityQuads(QuadBatch& batch, const EntitySnapshot& store, float alpha, const SDL_Color* colorByType) {
+    for (size_t i = 0; i < store.x.size(); i++) {
+        float x = store.prevX[i] + (store.x[i] - store.prevX[i]) * alpha;
+        float y = store.prevY[i] + (store.y[i] - store.prevY[i]) * alpha;
+        AddQuad(batch, floorf(x), floorf(y), store.w[i], store.h[i], colorByType[store.type[i]]);
     }
 }
 
-void SaveHighScore() {
-    std::ofstream file("score.txt");
-    if (file.is_open()) {
-        file << highScore;
-        file.close();
+// Reruns a recorded session without a window as fast as possible and checks the final state
+int RunReplay(const char* path) {
+    Replay replay;
+    if (!LoadReplay(path, replay)) return 1;
+    if (replay.simdLevel > DetectSimdLevel()) {
+        std::cerr << "Replay was recorded with " << SimdLevelName((SimdLevel)replay.simdLevel)
+                  << ", this CPU cannot match it bit for bit" << std::endl;
+    }
+    SetSimdLevel((SimdLevel)replay.simdLevel);
+    // The recorded table, not whatever waves.txt holds now
+    if (!SetWaveSource(replay.waves)) return 1;
+    SeedRng(gameRng, replay.seed);
+    persistHighScore = false;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    size_t next = 0;
+    while (simClock.tick < replay.endTick || next < replay.events.size()) {
+        BeginProfileFrame();
+        while (next < replay.events.size() && replay.events[next].tick == simClock.tick) {
+            HandleSimEvent(ToSdlEvent(replay.events[next++]));
+        }
+        bool stepped = false;
+        if (gameState == PLAYING && simClock.tick < replay.endTick) {
+            ProfileScope scope(STAGE_SIMULATION);
+            StepSimulation();
+            stepped = true;
+        }
+        EndProfileFrame();
+        // The clock only runs while playing; anything left at a frozen tick can never apply
+        if (!stepped && (next >= replay.events.size() || replay.events[next].tick != simClock.tick)) break;
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    Uint64 hash = HashGameState();
+    bool match = simClock.tick == replay.endTick && hash == replay.endHash;
+    std::cout << "replay " << path << ": " << replay.events.size() << " inputs, " << simClock.tick << " ticks in "
+              << seconds << " s, score " << score << ", " << (match ? "state matches" : "STATE DIVERGED") << std::endl;
+    if (!match) {
+        std::cout << "  expected tick " << replay.endTick << " hash " << replay.endHash
+                  << ", got tick " << simClock.tick << " hash " << hash << std::endl;
     }
+    return match ? 0 : 1;
 }
 
-void SpawnEnemy(int screenW, int screenH) {
-    Enemy e;
-    e.rect = { rand() % (screenW - 32), rand() % (screenH - 32), 32, 32 };
-    e.type = static_cast<EnemyType>(rand() % 3);
-    float angle = (rand() % 360) * 3.14159f / 180.0f;
-    float speed = 0.0f;
-    switch (e.type) {
-        case SLOW: speed = 50.0f; break;
-        case FAST: speed = 150.0f; break;
-        case RANGED: speed = 0.0f; break;
+// F3 overlay: rolling min/avg/p99 per frame stage
+void RenderProfilerOverlay(QuadBatch& shapes, QuadBatch& text, const FramePacer& pacer) {
+    const int x = 370, y = 130, rowHeight = 30;
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Color gray = { 180, 180, 180, 255 };
+    AddQuad(shapes, (float)x - 10, (float)y - 10, 430.0f, (float)(rowHeight * (STAGE_COUNT + 4) + 20), { 0, 0, 0, 255 });
+    DrawText(text, glyphAtlas, "ms", x, y, gray);
+    DrawText(text, glyphAtlas, "min", x + 210, y, gray);
+    DrawText(text, glyphAtlas, "avg", x + 280, y, gray);
+    DrawText(text, glyphAtlas, "p99", x + 350, y, gray);
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        StageStats stats = GetStageStats((ProfileStage)s);
+        int rowY = y + rowHeight * (s + 1);
+        DrawText(text, glyphAtlas, ProfileStageName((ProfileStage)s), x, rowY, white);
+        DrawText(text, glyphAtlas, ArenaFormat(frameArena, "%.2f", stats.minMs), x + 210, rowY, white);
+        DrawText(text, glyphAtlas, ArenaFormat(frameArena, "%.2f", stats.avgMs), x + 280, rowY, white);
+        DrawText(text, glyphAtlas, ArenaFormat(frameArena, "%.2f", stats.p99Ms), x + 350, rowY, white);
     }
-    e.vx = cosf(angle) * speed;
-    e.vy = sinf(angle) * speed;
-    enemies.push_back(e);
+    int rowY = y + rowHeight * (STAGE_COUNT + 1);
+    DrawText(text, glyphAtlas, ArenaFormat(frameArena, "missed %u of %u, worst %.1f ms", pacer.missed, pacer.frames,
+                                           pacer.worstLateMs), x, rowY, white);
+    SoundStats sound = GetSoundStats();
+    DrawText(text, glyphAtlas, ArenaFormat(frameArena, "voices %d/%d, dropped %u", sound.activeVoices, soundVoices,
+                                           sound.rateLimited + sound.overBudget + sound.queueFull), x, rowY + rowHeight, white);
+    const char* allocs = !AllocationCountingEnabled() ? "allocs not counted in this build" :
+        ArenaFormat(frameArena, "allocs %llu, %u of %u frames", (unsigned long long)lastFrameAllocs, allocatingFrames, playingFrames);
+    DrawText(text, glyphAtlas, allocs, x, rowY + rowHeight * 2, white);
 }
 
-void UpdateEnemies(float dt, int screenW, int screenH, SDL_Rect player) {
-    //for (auto& e : enemies) {
-    for (size_t i = 0; i < enemies.size();) {
-        Enemy& e = enemies[i];
-        if (e.type == SLOW || e.type == FAST) {
-            float dx = (float)(player.x + player.w / 2) - (e.rect.x + e.rect.w / 2);
-            float dy = (float)(player.y + player.h / 2) - (e.rect.y + e.rect.h / 2);
-            float length = sqrtf(dx * dx + dy * dy);
-            if (length != 0) {
-                dx /= length;
-                dy /= length;
-            }
+// Headless stand-in for a player: holds the keys that lead toward the coin
+Uint8 AutopilotKeys() {
+    const int deadZone = 4;
+    int dx = (itemRect.x + itemRect.w / 2) - (playerRect.x + playerRect.w / 2);
+    int dy = (itemRect.y + itemRect.h / 2) - (playerRect.y + playerRect.h / 2);
+    Uint8 keys = 0;
+    if (dx > deadZone) keys |= MOVE_RIGHT;
+    else if (dx < -deadZone) keys |= MOVE_LEFT;
+    if (dy > deadZone) keys |= MOVE_DOWN;
+    else if (dy < -deadZone) keys |= MOVE_UP;
+    return keys;
+}
 
-            float speed = enemyBaseSpeed + level * 15.0f;
-            e.rect.x += static_cast<int>(dx * speed * dt);
-            e.rect.y += static_cast<int>(dy * speed * dt);
-        } else {
-            Uint32 now = SDL_GetTicks();
-            if (now - lastShootTime > shootInterval) {
-                Projectile p;
-                p.rect = { e.rect.x + e.rect.w / 2 - 4, e.rect.y + e.rect.h / 2 - 4 , 8, 8 };
-                float dx = (player.x + player.w / 2.0f) - (e.rect.x + e.rect.w / 2.0f);
-                float dy = (player.y + player.h / 2.0f) - (e.rect.y + e.rect.h / 2.0f);
-                float lengthProjectile = sqrtf(dx * dx + dy * dy);
-                if (lengthProjectile != 0) {
-                    dx /= lengthProjectile;
-                    dy /= lengthProjectile;
-                }
-                float bulletSpeed = 200.0f;
-                p.vx = dx * bulletSpeed;
-                p.vy = dy * bulletSpeed;
-                projectiles.push_back(p);
-                lastShootTime = now;
+// Runs whole sessions with no window, renderer or audio, as fast as the CPU allows
+int RunHeadless(int sessions, int maxSeconds, Uint64 seed) {
+    persistHighScore = false;
+    std::cout << "simd: " << SimdLevelName(GetSimdLevel()) << ", job workers: " << JobWorkerCount() << std::endl;
+    Uint64 totalTicks = 0;
+    long long totalScore = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int s = 0; s < sessions; s++) {
+        // Each session gets its own seed, so any one of them can be rerun alone
+        SeedRng(gameRng, seed + s);
+        PlacePlayer(368.0f, 300.0f);
+        itemRect = { 400,400,32,32 };
+        StartNewGame();
+        Uint64 sessionStart = simClock.tick;
+        Uint64 maxTicks = (Uint64)maxSeconds * simTickRate;
+        while (gameState == PLAYING && simClock.tick - sessionStart < maxTicks) {
+            BeginProfileFrame();
+            heldMoveKeys = AutopilotKeys();
+            if (gameState == PLAYING) {
+                ProfileScope scope(STAGE_SIMULATION);
+                StepSimulation();
             }
+            EndProfileFrame();
         }
-        /*if (e.rect.x < 0) e.rect.x = 0;
-        if (e.rect.x + e.rect.w > screenW) e.rect.x = screenW - e.rect.w;
-        if (e.rect.y < 0) e.rect.y = 0;
-        if (e.rect.y + e.rect.h > screenH) e.rect.y = screenH - e.rect.h;*/
-        if (e.rect.x + e.rect.w < 0 || e.rect.x > screenW ||
-            e.rect.y + e.rect.h < 0 || e.rect.y > screenH) {
-            enemies.erase(enemies.begin() + i);
-            score += 5;
-            if (score > highScore) {
-                highScore = score;
-                SaveHighScore();
-            }
-        } else {
-            i++;
-        }
+        Uint64 ticks = simClock.tick - sessionStart;
+        totalTicks += ticks;
+        totalScore += score;
+        std::cout << "session " << s << " (seed " << seed + s << "): score " << score << " wave " << currentWave
+                  << " level " << level << " lives " << lives << " ticks " << ticks
+                  << " projectiles " << projectilePool.highWater << "/" << projectilePool.capacity
+                  << " refused " << projectilePool.exhausted << std::endl;
     }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    std::cout << sessions << " sessions, " << totalTicks << " ticks in " << seconds << " s, mean score "
+              << (sessions > 0 ? (double)totalScore / sessions : 0.0) << std::endl;
+    return 0;
 }
 
-void UpdateProjectiles(float dt, int screenW, int screenH) {
-    for (size_t i = 0; i < projectiles.size();) {
-        auto& p = projectiles[i];
-        p.rect.x += static_cast<int>(p.vx * dt);
-        p.rect.y += static_cast<int>(p.vy * dt);
-        if (SDL_HasIntersection(&p.rect, &playerRect) && !isInvulnerable) {
-            lives--;
-            isInvulnerable = true;
-            invulnerableStart = SDL_GetTicks();
-            projectiles.erase(projectiles.begin() + i);
-            continue;
-        }
-        if (p.rect.x < 0 || p.rect.x > screenW || p.rect.y < 0 || p.rect.y > screenH) {
-            projectiles.erase(projectiles.begin() + i);
-        } else {
-            i++;
+int main(int argc, char* argv[]) {
+    bool headless = false;
+    int sessions = 1;
+    int maxSeconds = 120;
+    const char* profileCsv = nullptr;
+    const char* profileTrace = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* packPath = "assets.pak";
+    const char* wavesPath = "assets/waves.txt";
+    int threads = SDL_GetCPUCount() - 1;
+    int fps = 60;
+    bool vsync = false;
+    Uint64 seed = (Uint64)time(nullptr);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--sessions" && i + 1 < argc) sessions = std::atoi(argv[++i]);
+        else if (arg == "--max-seconds" && i + 1 < argc) maxSeconds = std::atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc) replayPath = argv[++i];
+        else if (arg == "--profile-csv" && i + 1 < argc) profileCsv = argv[++i];
+        else if (arg == "--profile-trace" && i + 1 < argc) profileTrace = argv[++i];
+        else if (arg == "--pack" && i + 1 < argc) packPath = argv[++i];
+        else if (arg == "--loose-assets") packPath = nullptr;
+        else if (arg == "--waves" && i + 1 < argc) wavesPath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (arg == "--fps" && i + 1 < argc) fps = std::atoi(argv[++i]);
+        else if (arg == "--vsync") vsync = true;
+        else if (arg == "--simd" && i + 1 < argc) {
+            SimdLevel level;
+            if (!ParseSimdLevel(argv[++i], level)) {
+                std::cerr << "--simd: expected scalar, sse2 or avx2, got " << argv[i] << std::endl;
+                return 1;
+            }
+            if (level > DetectSimdLevel()) {
+                std::cerr << "--simd: this CPU lacks " << SimdLevelName(level) << ", using "
+                          << SimdLevelName(DetectSimdLevel()) << std::endl;
+                level = DetectSimdLevel();
+            }
+            SetSimdLevel(level);
         }
     }
-}
-
-void StartWave() {
-    enemies.clear();
-    enemiesToSpawn = currentWave * 3;
-    for (int i = 0; i < enemiesToSpawn; i++) {
-        SpawnEnemy(800, 600);
+    InitGrid(enemyGrid, 800, 600, 64);
+    InitGrid(projectileGrid, 800, 600, 64);
+    LoadWaveFile(wavesPath);
+    // Chunked updates merge in a fixed order, so the thread count never changes the outcome
+    StartJobSystem(threads);
+    if (!InitProfiler(profileCsv, profileTrace)) return 1;
+    if (replayPath || headless) {
+        int result = replayPath ? RunReplay(replayPath) : RunHeadless(sessions, maxSeconds, seed);
+        ShutdownProfiler();
+        return result;
     }
-    waveInProgress = true;
-    waveStartTime = SDL_GetTicks();
-    lastWaveTime = waveStartTime;
 
-}
-
-int main(int argc, char* argv[]) {
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     SDL_Texture* spritesheet = nullptr;
-    if (!Init(&window, &renderer, 800, 600)) return 1;
+    if (!Init(&window, &renderer, 800, 600, vsync)) return 1;
+    if (vsync) {
+        SDL_DisplayMode mode;
+        if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &mode) == 0 && mode.refresh_rate > 0) {
+            fps = mode.refresh_rate;
+        }
+    }
 
-    TTF_Font* font = TTF_OpenFont("assets/font.ttf", 24);
-    if (!font) {
-        std::cerr << "Failed to load font\n";
+    // Everything the menu and gameplay need first; music and end-of-game sounds stream in behind the menu
+    AssetLoader assets;
+    AssetPack pack;
+    // The pack is optional: without it (or for anything it lacks) assets load from the loose files
+    if (packPath && OpenAssetPack(pack, packPath)) assets.pack = &pack;
+    int fontId = QueueAsset(assets, "assets/font.ttf", ASSET_FONT, true, 24);
+    int heartId = QueueAsset(assets, "assets/heart.png", ASSET_TEXTURE, true);
+    int spritesheetId = QueueAsset(assets, "assets/spritesheet.png", ASSET_TEXTURE, true);
+    int coinId = QueueAsset(assets, "assets/coin.png", ASSET_TEXTURE, true);
+    int correctId = QueueAsset(assets, "assets/correct.wav", ASSET_CHUNK, true);
+    int wrongId = QueueAsset(assets, "assets/wrong.wav", ASSET_CHUNK, true);
+    int musicId = QueueAsset(assets, "assets/music.ogg", ASSET_MUSIC, false);
+    int winId = QueueAsset(assets, "assets/victory.wav", ASSET_CHUNK, false);
+    int gameoverId = QueueAsset(assets, "assets/gameover.wav", ASSET_CHUNK, false);
+    StartAssetLoader(assets, SDL_GetCPUCount());
+    if (!WaitForCriticalAssets(assets, renderer)) {
+        DestroyAssets(assets);
+        CloseAssetPack(pack);
         return 1;
     }
-    Button playButton = { {300,250,200,60}, {0,120,255}, "PLAY"};
-    Button restartButton = { {300,330,200,60}, {0,200,100}, "RESTART"};
+
+    TTF_Font* font = GetFont(assets, fontId);
+    if (!BuildGlyphAtlas(glyphAtlas, font, renderer)) return 1;
     bool running = true;
     SDL_Event event;
-    Uint32 lastTick = SDL_GetTicks();
     int alpha = 0;
     Uint32 fadeStart = 0;
 
-    heartTex = LoadTexture("assets/heart.png", renderer);
-    if (!heartTex) return 1;
-    
-    spritesheet = LoadTexture("assets/spritesheet.png", renderer);
-    if (!spritesheet) return 1;
-
-    itemTex = LoadTexture("assets/coin.png", renderer);
-    if (!itemTex) return 1;
+    heartTex = GetTexture(assets, heartId);
+    spritesheet = GetTexture(assets, spritesheetId);
+    itemTex = GetTexture(assets, coinId);
 
     const int frameWidth = 64;
     const int frameHeight = 64;
@@ -314,176 +365,101 @@ int main(int argc, char* argv[]) {
     Uint32 frameDuration = 150;
     Uint32 lastFrameTime = SDL_GetTicks();
 
-    Mix_Music* bgMusic = Mix_LoadMUS("assets/music.ogg");
-    Mix_Chunk* correctSound = Mix_LoadWAV("assets/correct.wav");
-    Mix_Chunk* wrongSound = Mix_LoadWAV("assets/wrong.wav");
-    Mix_Chunk* winSound = Mix_LoadWAV("assets/victory.wav");
-    Mix_Chunk* gameoverSound = Mix_LoadWAV("assets/gameover.wav");
-    if (!bgMusic || !correctSound || !wrongSound || !winSound || !gameoverSound) return 1;
-
-    srand(static_cast<unsigned>(time(nullptr)));
-
+    Mix_Music* bgMusic = nullptr;
+    SetSoundChunk(SOUND_CORRECT, GetChunk(assets, correctId));
+    SetSoundChunk(SOUND_WRONG, GetChunk(assets, wrongId));
+    // The sim only queues sounds; the mixer is driven from this thread
+    if (audioEnabled) gameSoundHook = QueueGameSound;
+
+    SeedRng(gameRng, seed);
+    if (recordPath) {
+        recordingInput = true;
+        recording.seed = seed;
+        recording.simdLevel = (Uint8)GetSimdLevel();
+        recording.waves = waveSource;
+    }
 
     LoadHighScore();
+    // From here until StopSimThread the sim thread owns the game state
+    GameState lastState = gameState;
+    Uint8 sentMoveKeys = 0;
+    FramePacer pacer;
+    InitFramePacer(pacer, fps, vsync);
+    StartSimThread(recordingInput ? &recording : nullptr);
     //Playing game
     while (running) {
+        BeginProfileFrame();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        Uint64 allocStart = AllocationCount();
+        if (AssetsPending(assets)) {
+            PumpAssets(assets, renderer);
+            bgMusic = GetMusic(assets, musicId);
+            SetSoundChunk(SOUND_VICTORY, GetChunk(assets, winId));
+            SetSoundChunk(SOUND_GAMEOVER, GetChunk(assets, gameoverId));
+        }
+        bool gotEvents = false;
         while (SDL_PollEvent(&event)) {
+            gotEvents = true;
             if (event.type == SDL_QUIT) running = false;
-            if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
-                int x = event.button.x;
-                int y = event.button.y;
-                SDL_Point clickPoint = { x,y };
-
-                switch (gameState) {
-                case MENU:
-                    if (SDL_PointInRect(&clickPoint, &playButton.rect)) {
-                        gameState = PLAYING;
-                        score = 0;
-                        lives = 3;
-                        level = 1;
-                        currentWave = 1;
-                        enemies.clear();
-                        StartWave();
-                        gameStartTime = SDL_GetTicks();
-
-                        alpha = 0;
-                        fadeStart = SDL_GetTicks();
-                    }
-                    break;
-                case GAME_OVER:
-                    if (SDL_PointInRect(&clickPoint, &restartButton.rect)) {
-                        score = 0;
-                        lives = 3;
-                        level = 1;
-                        enemies.clear();
-                        isInvulnerable = false;
-                        waveInProgress = true;
-                        currentWave = 1;
-                        gameState = MENU;
-                    }
-                    break;
-                case VICTORY:
-                    if (SDL_PointInRect(&clickPoint, &restartButton.rect)) {
-                        score = 0;
-                        lives = 3;
-                        level = 1;
-                        enemies.clear();
-                        isInvulnerable = false;
-                        waveInProgress = true;
-                        currentWave = 1;
-                        gameState = MENU;
-                    }
-                    break;
-                }
-            }
-            if (event.type == SDL_KEYDOWN) {
-                switch (gameState) {
-                case PLAYING: { 
-                    SDL_Keycode pressed = event.key.keysym.sym;
-                    
-                    timeLimit = 30 - (level - 1) * 5;
-                    if (timeLimit < 10) timeLimit = 10;
-                    Uint32 now = SDL_GetTicks();
-                    int timeLeft = timeLimit - (now - gameStartTime) / 1000;
-                    if (timeLeft <= 0) {
-                        Mix_HaltMusic();
-                        Mix_PlayChannel(-1, gameoverSound, 0);
-                        gameState = GAME_OVER;
-                    }
-                    if (event.key.keysym.sym == SDLK_p) {
-                        gameState = PAUSED;
-                    }
-                    if (pressed == SDLK_w) playerRect.y -= playerSpeed;
-                    if (pressed == SDLK_s) playerRect.y += playerSpeed;
-                    if (pressed == SDLK_a) playerRect.x -= playerSpeed;
-                    if (pressed == SDLK_d) playerRect.x += playerSpeed;
-                    
-                    if (SDL_HasIntersection(&playerRect, &itemRect)) {
-                        score += 10;
-                        itemRect.x = rand() % (800 - itemRect.w);
-                        itemRect.y = rand() % (600 - itemRect.h);
-
-                        if (score % 30 == 0) {
-                            level++;
-                        }
-
-                        if (score > highScore) {
-                            highScore = score;
-                            SaveHighScore();
-                        }
-                    }
-                    if (!isInvulnerable) {
-                        for (auto& e : enemies) {
-                            if (SDL_HasIntersection(&playerRect, &e.rect)) {
-                                lives--;
-                                Mix_PlayChannel(-1, wrongSound, 0);
-                                isInvulnerable = true;
-                                invulnerableStart = SDL_GetTicks();
-
-                                if (lives <= 0) {
-                                    Mix_HaltMusic();
-                                    Mix_PlayChannel(-1, gameoverSound, 0);
-                                    gameState = GAME_OVER;
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    if (isInvulnerable) {
-                        Uint32 now = SDL_GetTicks();
-                        if (now - invulnerableStart >= invulnerableDuration) isInvulnerable = false;
-                    }
-                    break;
-                }
-                case PAUSED:
-                    if (event.key.keysym.sym == SDLK_p) {
-                        gameState = PLAYING;
-                    }
-                    if (event.key.keysym.sym == SDLK_ESCAPE) {
-                        gameState = MENU;
-                    }
-                    break;
-                }
-            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) showProfiler = !showProfiler;
+            if (IsSimEvent(event)) PushSimInput(event);
         }
-
-        float dt = (SDL_GetTicks() - lastTick) / 1000.0f;
-        lastTick = SDL_GetTicks();
-
-        if (waveInProgress) {
-            Uint32 now = SDL_GetTicks();
-            if (now - waveStartTime >= waveDelay) {
-                currentWave++;
-                score += 20;
-                StartWave();
+        // Movement follows what is held, not key repeat; the sim only hears about changes
+        Uint8 moveKeys = MoveKeysFromKeyboard(SDL_GetKeyboardState(nullptr));
+        if (moveKeys != sentMoveKeys && PushSimInput(MakeMoveKeysEvent(moveKeys))) sentMoveKeys = moveKeys;
+
+        Uint64 nowCounter = SDL_GetPerformanceCounter();
+        AddProfileSample(STAGE_EVENTS, frameStart, nowCounter);
+        const GameSnapshot& snap = LatestSnapshot();
+        // Only gameplay animates. The other screens change on input or when the sim changes state,
+        // so between those they block on the event queue instead of redrawing the same frame.
+        // After an input they stay awake until a snapshot shows its effect.
+        bool simCaughtUp = snap.inputsApplied == SimInputsQueued();
+        if (snap.state != PLAYING && snap.state == lastState && !gotEvents && simCaughtUp) {
+            {
+                ProfileScope scope(STAGE_SLEEP);
+                // Short waits while assets still stream in, so they keep loading behind the menu
+                SDL_WaitEventTimeout(nullptr, AssetsPending(assets) ? 1000 / std::max(fps, 1) : idleWaitMs);
             }
+            ResetFramePacer(pacer);
+            ResetArena(frameArena);
+            EndProfileFrame();
+            continue;
+        }
+        if (lastState == MENU && snap.state == PLAYING) {
+            alpha = 0;
+            fadeStart = SDL_GetTicks();
         }
+        lastState = snap.state;
+        // Music first, so the end-of-game sounds start after it stops
+        UpdateMusic(bgMusic, snap.state);
+        UpdateSoundManager();
+        // How far we are past the newest tick, as a fraction of a tick
+        double sinceTick = (double)(nowCounter - snap.publishedAt) * simTickRate / SDL_GetPerformanceFrequency();
+        float interp = (float)std::min(1.0, std::max(0.0, sinceTick));
 
         SDL_SetRenderDrawColor(renderer, 30, 30, 30, 255);
         SDL_RenderClear(renderer);
         //Rendering game
-        switch (gameState) {
+        switch (snap.state) {
             case MENU: {
                 int mx, my;
                 SDL_GetMouseState(&mx, &my);
                 SDL_Point mousePoint = { mx, my };
 
                 bool hoveredPlay = SDL_PointInRect(&mousePoint, &playButton.rect);
-                RenderButton(renderer, font, playButton, hoveredPlay);
+                RenderButton(renderer, textBatch, playButton, hoveredPlay);
                 break;
             }
             case PLAYING: {
-                RenderHUD(renderer, font);
-                UpdateEnemies(dt, 800, 600, playerRect);
-                UpdateProjectiles(dt, 800, 600);
-                std::string msg = "Avoid the enemies!";
+                Uint64 hudStart = SDL_GetPerformanceCounter();
+                RenderHUD(renderer, textBatch, snap);
+                AddProfileSample(STAGE_RENDER_HUD, hudStart, SDL_GetPerformanceCounter());
+                static TextLabel bannerLabel;
                 SDL_Color c = { 0, 255, 255, 255 };
-                SDL_Texture* t = RenderText(msg, font, c, renderer);
-                SDL_Rect r = { 300,100,0,0 };
-                SDL_QueryTexture(t, nullptr, nullptr, &r.w, &r.h);
-                SDL_RenderCopy(renderer, t, nullptr, &r);
-                SDL_DestroyTexture(t);
+                DrawLabel(textBatch, glyphAtlas, bannerLabel, "Avoid the enemies!", 300, 100, c);
                 
+                ProfileScope scope(STAGE_DRAW_ENTITIES);
                 Uint32 now = SDL_GetTicks();
                 if (now - lastFrameTime >= frameDuration) {
                     currentFrame = (currentFrame + 1) % numFrames;
@@ -495,87 +471,109 @@ int main(int argc, char* argv[]) {
                     if (alpha > 255) alpha = 255;
                     SDL_SetTextureAlphaMod(spritesheet, (Uint8)alpha);
                 }
-                if (isInvulnerable && ((SDL_GetTicks()/100)%2 == 0)){
+                if (snap.isInvulnerable && ((SDL_GetTicks()/100)%2 == 0)){
                     SDL_SetTextureAlphaMod(spritesheet, 120);
                 } else {
                     SDL_SetTextureAlphaMod(spritesheet, 255);
                 }
                 SDL_Rect srcRect = { currentFrame * frameWidth, 0, frameWidth, frameHeight };
                 SDL_Rect dstRect = { 368, 300, frameWidth, frameHeight };
-                SDL_RenderCopy(renderer, spritesheet, &srcRect, &playerRect);
-                SDL_RenderCopy(renderer, itemTex, nullptr, &itemRect);
-                for (auto& e : enemies) {
-                    switch (e.type) {
-                        case RANGED: SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); break;
-                        case SLOW: SDL_SetRenderDrawColor(renderer, 0, 128, 255, 255); break;
-                        case FAST: SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); break;
-                    }
-                    SDL_RenderFillRect(renderer, &e.rect);
-                }
-                for (auto& p : projectiles) {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                    SDL_RenderFillRect(renderer, &p.rect);
-                }
+                SDL_Rect playerDst = snap.player;
+                playerDst.x = (int)floorf(snap.playerPrevX + (snap.playerX - snap.playerPrevX) * interp);
+                playerDst.y = (int)floorf(snap.playerPrevY + (snap.playerY - snap.playerPrevY) * interp);
+                SDL_RenderCopy(renderer, spritesheet, &srcRect, &playerDst);
+                SDL_RenderCopy(renderer, itemTex, nullptr, &snap.item);
+                // Draw calls stay flat however big the wave: one for every enemy and projectile
+                const SDL_Color projectileColor[] = { { 255, 255, 255, 255 } };
+                AddEntityQuads(shapeBatch, snap.enemies, interp, snap.enemyColors);
+                AddEntityQuads(shapeBatch, snap.projectiles, interp, projectileColor);
+                FlushQuads(shapeBatch, nullptr, renderer);
                 break;
             }
             case VICTORY: {
+                static TextLabel winLabel;
                 SDL_Color c = { 0, 255, 0, 255 };
-                SDL_Texture* t = RenderText("You Win!", font, c, renderer);
-                SDL_Rect r = { 150, 250, 0, 0 };
-                SDL_QueryTexture(t, nullptr, nullptr, &r.w, &r.h);
-                SDL_RenderCopy(renderer, t, nullptr, &r);
-                SDL_DestroyTexture(t);
+                DrawLabel(textBatch, glyphAtlas, winLabel, "You Win!", 150, 250, c);
 
                 int mx, my;
                 SDL_GetMouseState(&mx, &my);
                 SDL_Point mousePoint = { mx, my };
 
                 bool hoveredRestart = SDL_PointInRect(&mousePoint, &restartButton.rect);
-                RenderButton(renderer, font, restartButton, hoveredRestart);
+                RenderButton(renderer, textBatch, restartButton, hoveredRestart);
                 break;
             }
             case GAME_OVER: {
+                static TextLabel gameOverLabel;
                 SDL_Color c = { 255, 0, 0, 255 };
-                SDL_Texture* t = RenderText("Game Over", font, c, renderer);
-                SDL_Rect r = { 150, 250, 0, 0 };
-                SDL_QueryTexture(t, nullptr, nullptr, &r.w, &r.h);
-                SDL_RenderCopy(renderer, t, nullptr, &r);
-                SDL_DestroyTexture(t);
+                DrawLabel(textBatch, glyphAtlas, gameOverLabel, "Game Over", 150, 250, c);
 
                 int mx, my;
                 SDL_GetMouseState(&mx, &my);
                 SDL_Point mousePoint = { mx, my };
 
                 bool hoveredRestart = SDL_PointInRect(&mousePoint, &restartButton.rect);
-                RenderButton(renderer, font, restartButton, hoveredRestart);
+                RenderButton(renderer, textBatch, restartButton, hoveredRestart);
                 break;
             }
             case PAUSED: {
+                static TextLabel pausedLabel;
                 SDL_Color c = { 255, 255, 255, 255 };
-                SDL_Texture* t = RenderText("Game Paused. Press P to Resume or ESC to Menu", font, c, renderer);
-                SDL_Rect r = { 100, 250, 0, 0 };
-                SDL_QueryTexture(t, nullptr, nullptr, &r.w, &r.h);
-                SDL_RenderCopy(renderer, t, nullptr, &r);
-                SDL_DestroyTexture(t);
+                DrawLabel(textBatch, glyphAtlas, pausedLabel, "Game Paused. Press P to Resume or ESC to Menu", 100, 250, c);
                 break;
             }
         }
 
-        SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        if (showProfiler) {
+            RenderProfilerOverlay(shapeBatch, textBatch, pacer);
+            FlushQuads(shapeBatch, nullptr, renderer);
+        }
+        {
+            ProfileScope scope(STAGE_DRAW_TEXT);
+            FlushQuads(textBatch, glyphAtlas.texture, renderer);
+        }
+        {
+            ProfileScope scope(STAGE_PRESENT);
+            SDL_RenderPresent(renderer);
+        }
+        AddProfileSample(STAGE_FRAME, frameStart, SDL_GetPerformanceCounter());
+        {
+            ProfileScope scope(STAGE_SLEEP);
+            WaitForNextFrame(pacer);
+        }
+        ResetArena(frameArena);
+        lastFrameAllocs = AllocationCount() - allocStart;
+        if (snap.state == PLAYING) {
+            playingFrames++;
+            if (lastFrameAllocs) allocatingFrames++;
+        }
+        EndProfileFrame();
+    }
+    StopSimThread();
+    std::cout << "frames: " << pacer.frames << " at " << fps << " Hz" << (vsync ? " (vsync)" : "")
+              << ", missed deadlines: " << pacer.missed << ", worst " << pacer.worstLateMs << " ms late" << std::endl;
+    SoundStats sound = GetSoundStats();
+    std::cout << "sounds played: " << sound.played << " (" << sound.stolen << " stole a voice), dropped: "
+              << sound.rateLimited << " rate limited, " << sound.overBudget << " over budget, "
+              << sound.queueFull << " queue full" << std::endl;
+    if (AllocationCountingEnabled()) {
+        std::cout << "gameplay frames that allocated: " << allocatingFrames << " of " << playingFrames << std::endl;
     }
-    Mix_FreeMusic(bgMusic);
-    Mix_FreeChunk(correctSound);
-    Mix_FreeChunk(wrongSound);
-    Mix_FreeChunk(winSound);
-    Mix_FreeChunk(gameoverSound);
+    CloseHighScore();
+    ShutdownProfiler();
+    if (recordingInput) {
+        recording.endTick = simClock.tick;
+        recording.endHash = HashGameState();
+        SaveReplay(recordPath, recording);
+    }
+    DestroyAssets(assets);
+    CloseAssetPack(pack);
     Mix_CloseAudio();
-    TTF_CloseFont(font);
-    SDL_DestroyTexture(heartTex);
-    SDL_DestroyTexture(itemTex);
+    DestroyGlyphAtlas(glyphAtlas);
+    DestroyArena(frameArena);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
     SDL_Quit();
     return 0;
-}
\ No newline at end of file
+}
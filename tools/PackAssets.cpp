@@ -0,0 +1,138 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../AssetPack.h"
+
+// Build step: turns the loose assets/ directory into assets.pak.
+//   PackAssets [assets] [assets.pak]
+// PNGs become RGBA32 pixels and WAVs become PCM in the format the game opens the mixer
+// with (44100 Hz, signed 16-bit, stereo); everything else is copied verbatim.
+
+const int mixFrequency = 44100;
+const SDL_AudioFormat mixFormat = AUDIO_S16SYS;
+const int mixChannels = 2;
+
+struct PackedFile {
+    PackEntry entry;
+    std::vector<Uint8> bytes;
+};
+
+static bool PackImage(const std::string& path, PackedFile& out) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) return false;
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) return false;
+    size_t rowBytes = (size_t)rgba->w * 4;
+    out.bytes.resize(rowBytes * rgba->h);
+    SDL_LockSurface(rgba);
+    for (int y = 0; y < rgba->h; y++) {
+        memcpy(&out.bytes[y * rowBytes], (const Uint8*)rgba->pixels + (size_t)y * rgba->pitch, rowBytes);
+    }
+    SDL_UnlockSurface(rgba);
+    out.entry.kind = PACK_RGBA;
+    out.entry.width = (Uint32)rgba->w;
+    out.entry.height = (Uint32)rgba->h;
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+static bool PackWav(const std::string& path, PackedFile& out) {
+    SDL_AudioSpec spec;
+    Uint8* buf = nullptr;
+    Uint32 len = 0;
+    if (!SDL_LoadWAV(path.c_str(), &spec, &buf, &len)) return false;
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, mixFormat, mixChannels, mixFrequency) < 0) {
+        SDL_FreeWAV(buf);
+        return false;
+    }
+    std::vector<Uint8> work((size_t)len * std::max(1, cvt.len_mult));
+    memcpy(work.data(), buf, len);
+    SDL_FreeWAV(buf);
+    cvt.buf = work.data();
+    cvt.len = (int)len;
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) return false;
+    work.resize(cvt.needed ? (size_t)cvt.len_cvt : len);
+    out.bytes.swap(work);
+    out.entry.kind = PACK_PCM;
+    out.entry.freq = mixFrequency;
+    out.entry.format = mixFormat;
+    out.entry.channels = mixChannels;
+    return true;
+}
+
+static bool PackRaw(const std::string& path, PackedFile& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    out.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    out.entry.kind = PACK_FILE;
+    return true;
+}
+
+static Uint64 AlignUp(Uint64 value) {
+    return (value + packAlignment - 1) / packAlignment * packAlignment;
+}
+
+int main(int argc, char* argv[]) {
+    std::string dir = argc > 1 ? argv[1] : "assets";
+    std::string outPath = argc > 2 ? argv[2] : "assets.pak";
+
+    std::vector<std::string> paths;
+    for (const auto& item : std::filesystem::directory_iterator(dir)) {
+        if (item.is_regular_file()) paths.push_back((std::filesystem::path(dir) / item.path().filename()).generic_string());
+    }
+    std::sort(paths.begin(), paths.end()); // stable output for the same inputs
+
+    std::vector<PackedFile> files;
+    for (const std::string& path : paths) {
+        PackedFile file;
+        memset(&file.entry, 0, sizeof(file.entry));
+        if (path.size() >= sizeof(file.entry.name)) {
+            std::cerr << "Name too long for the pack: " << path << std::endl;
+            return 1;
+        }
+        strcpy(file.entry.name, path.c_str());
+        std::string ext = std::filesystem::path(path).extension().string();
+        bool ok = ext == ".png" ? PackImage(path, file) : ext == ".wav" ? PackWav(path, file) : PackRaw(path, file);
+        if (!ok) {
+            std::cerr << "Error packing " << path << ": " << SDL_GetError() << std::endl;
+            return 1;
+        }
+        files.push_back(std::move(file));
+    }
+
+    PackHeader header;
+    memcpy(header.magic, packMagic, 4);
+    header.version = packVersion;
+    header.entryCount = (Uint32)files.size();
+    header.reserved = 0;
+    Uint64 offset = AlignUp(sizeof(PackHeader) + files.size() * sizeof(PackEntry));
+    for (PackedFile& file : files) {
+        file.entry.offset = offset;
+        file.entry.size = file.bytes.size();
+        offset = AlignUp(offset + file.bytes.size());
+    }
+
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Cannot write " << outPath << std::endl;
+        return 1;
+    }
+    out.write((const char*)&header, sizeof(header));
+    for (const PackedFile& file : files) out.write((const char*)&file.entry, sizeof(file.entry));
+    const char zeros[packAlignment] = {};
+    for (const PackedFile& file : files) {
+        out.write(zeros, file.entry.offset - (Uint64)out.tellp());
+        out.write((const char*)file.bytes.data(), file.bytes.size());
+        std::cout << file.entry.name << ": " << file.bytes.size() << " bytes" << std::endl;
+    }
+    return out.good() ? 0 : 1;
+}